@@ -408,6 +408,28 @@ bool factory_builder_t::check_construction_site(koord pos, koord size, factory_d
 }
 
 
+/// candidate sites of find_random_construction_site(), checked in parallel
+struct construction_site_batch_t
+{
+	vector_tpl<koord> sites;
+	vector_tpl<bool> ok;
+	koord size;
+	factory_desc_t::site_t site;
+	bool is_factory;
+	climate_bits climates;
+	uint16 regions_allowed;
+};
+
+
+void factory_builder_t::check_construction_sites(void *data, uint32 first, uint32 last)
+{
+	construction_site_batch_t *batch = (construction_site_batch_t *)data;
+	for(  uint32 i = first;  i < last;  i++  ) {
+		batch->ok[i] = check_construction_site( batch->sites[i], batch->size, batch->site, batch->is_factory, batch->climates, batch->regions_allowed );
+	}
+}
+
+
 koord3d factory_builder_t::find_random_construction_site(koord pos, int radius, koord size, factory_desc_t::site_t site, const building_desc_t *desc, bool ignore_climates, uint32 max_iterations)
 {
 	bool is_factory = desc->get_type()==building_desc_t::factory;
@@ -432,21 +454,55 @@ koord3d factory_builder_t::find_random_construction_site(koord pos, int radius,
 	const uint32 a = diam+1;
 	const uint32 c = 37; // very unlikely to have this as a factor in somewhere ...
 
+	construction_site_batch_t batch;
+	batch.size = size;
+	batch.site = site;
+	batch.is_factory = is_factory;
+	batch.climates = climates;
+	batch.regions_allowed = desc->get_allowed_region_bits();
+
+	// the sites are checked in batches in parallel; batches grow as long as nothing is found
+	uint32 batch_size = 1;
+#ifdef MULTI_THREAD
+	const uint32 max_batch_size = env_t::num_threads > 1 ? 64 * env_t::num_threads : 1;
+#else
+	const uint32 max_batch_size = 1;
+#endif
+
 	// in order to stop on the first occurence, one has to iterate over all tiles in a reproducable but random enough manner
-	for(  uint32 i = 0;  i<max_iterations; i++,  index = (a*index+c) % area  ) {
+	for(  uint32 i = 0;  i<max_iterations;  ) {
 
-		// so it is guaranteed that the iteration hits all tiles and does not repeat itself
-		k = koord( pos.x - radius + (index % diam), pos.y - radius + (index / diam) );
+		batch.sites.clear();
+		for(  ;  i<max_iterations  &&  batch.sites.get_count()<batch_size;  i++,  index = (a*index+c) % area  ) {
+			// so it is guaranteed that the iteration hits all tiles and does not repeat itself
+			batch.sites.append( koord( pos.x - radius + (index % diam), pos.y - radius + (index / diam) ) );
+		}
 
 		// check place (it will actually check an grosse.x/y size rectangle, so we can iterate over less tiles)
-		if(  factory_builder_t::check_construction_site(k, size, site, is_factory, climates, desc->get_allowed_region_bits())  ) {
-			// then accept first hit
-			if (site != factory_desc_t::Water && site != factory_desc_t::Land) {
-				DBG_MESSAGE("factory_builder_t::find_random_construction_site","Found spot for %d at %s / %d\n", site, k.get_str(), max_iterations);
+		batch.ok.clear();
+		batch.ok.resize( batch.sites.get_count() );
+		for(  uint32 j = 0;  j < batch.sites.get_count();  j++  ) {
+			batch.ok.append( false );
+		}
+		if(  batch.sites.get_count() > 1  ) {
+			welt->world_index_loop( &factory_builder_t::check_construction_sites, &batch, batch.sites.get_count() );
+		}
+		else {
+			check_construction_sites( &batch, 0, batch.sites.get_count() );
+		}
+
+		for(  uint32 j = 0;  j < batch.sites.get_count();  j++  ) {
+			if(  batch.ok[j]  ) {
+				k = batch.sites[j];
+				// then accept first hit
+				if (site != factory_desc_t::Water && site != factory_desc_t::Land) {
+					DBG_MESSAGE("factory_builder_t::find_random_construction_site","Found spot for %d at %s / %d\n", site, k.get_str(), max_iterations);
+				}
+				// we accept first hit
+				goto finish;
 			}
-			// we accept first hit
-			goto finish;
 		}
+		batch_size = min( batch_size * 2, max_batch_size );
 	}
 	// nothing found
 	if (site != factory_desc_t::Water  &&  site != factory_desc_t::Land) {
@@ -882,8 +938,17 @@ int factory_builder_t::build_chain_link(const fabrik_t* origin_fab, const factor
 		}
 	}
 
+	// with a limited distance only the factories nearby need to be checked
+	vector_tpl<fabrik_t *> nearby_fabs;
+	const bool search_nearby = max_distance_to_supplier < welt->get_size_max();
+	if(  search_nearby  ) {
+		const koord origin_pos = origin_fab->get_pos().get_2d();
+		const koord range( max_distance_to_supplier, max_distance_to_supplier );
+		welt->get_factory_grid().get_in_rect( origin_pos - range, origin_pos + range, nearby_fabs );
+	}
+
 	// search if there already is one or two (cross-connect everything if possible)
-	for(auto const fab : welt->get_fab_list())
+	for(auto const fab : search_nearby ? nearby_fabs : welt->get_fab_list())
 	{
 		// Try to find matching factories for this consumption, but don't find more than two times number of factories requested.
 		//if ((supplier_count != 0 || consumption <= 0) && supplier_count < suppliers_found + 1) break;
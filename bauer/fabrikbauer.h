@@ -138,6 +138,9 @@ private:
 	 */
 	static bool check_construction_site(koord pos, koord size, factory_desc_t::site_t site, bool is_factory, climate_bits cl, uint16 regions_allowed);
 
+	/// check_construction_site() for the sites first..last-1 of a construction_site_batch_t
+	static void check_construction_sites(void *batch, uint32 first, uint32 last);
+
 	/**
 	 * Find a random site to place a factory.
 	 * @param radius Radius of the search circle around @p pos
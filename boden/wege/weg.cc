@@ -4,6 +4,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <tuple>
 
 #include "../../tpl/slist_tpl.h"
@@ -63,6 +64,17 @@ pthread_mutex_t weg_t::private_car_route_map::route_map_mtx = PTHREAD_MUTEX_INIT
 vector_tpl <weg_t *> alle_wege;
 
 static slist_tpl<std::tuple<weg_t*, uint32, uint32>> pending_road_travel_time_updates;
+
+uint32 weg_t::statistics_month = 0;
+way_statistics_t *weg_t::statistics_chunks[MAX_WAY_STATISTICS_CHUNKS];
+
+/// entries of the statistics store handed out so far (entry 0 is never used) and the released ones
+static uint32 way_statistics_count = 1;
+static vector_tpl<uint32> free_way_statistics;
+
+#ifdef MULTI_THREAD
+static pthread_mutex_t way_statistics_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
 /**
  * Get list of all ways
  */
@@ -342,21 +354,76 @@ void weg_t::set_desc(const way_desc_t *b, bool from_saved_game)
 
 
 /**
- * initializes statistic array
+ * clears the statistics
  */
 void weg_t::init_statistics()
 {
-	for(  int type=0;  type<MAX_WAY_STATISTICS;  type++  ) {
-		for(  int month=0;  month<MAX_WAY_STAT_MONTHS;  month++  ) {
-			statistics[month][type] = 0;
+	release_statistics();
+	creation_month_year = welt->get_timeline_year_month();
+}
+
+
+void weg_t::release_statistics()
+{
+	if(  statistics_index == 0  ) {
+		return;
+	}
+#ifdef MULTI_THREAD
+	pthread_mutex_lock( &way_statistics_mutex );
+#endif
+	free_way_statistics.append( statistics_index );
+	statistics_index = 0;
+#ifdef MULTI_THREAD
+	pthread_mutex_unlock( &way_statistics_mutex );
+#endif
+}
+
+
+way_statistics_t &weg_t::start_statistics_month()
+{
+	if(  statistics_index == 0  ) {
+#ifdef MULTI_THREAD
+		pthread_mutex_lock( &way_statistics_mutex );
+#endif
+		uint32 index;
+		if(  !free_way_statistics.empty()  ) {
+			index = free_way_statistics.pop_back();
 		}
+		else {
+			index = way_statistics_count++;
+			way_statistics_t *&chunk = statistics_chunks[index >> WAY_STATISTICS_CHUNK_SHIFT];
+			if(  chunk == NULL  ) {
+				if(  (index >> WAY_STATISTICS_CHUNK_SHIFT) >= MAX_WAY_STATISTICS_CHUNKS-1  ) {
+					dbg->fatal( "weg_t::start_statistics_month()", "Too many ways with traffic" );
+				}
+				chunk = new way_statistics_t[WAY_STATISTICS_CHUNK_SIZE];
+			}
+		}
+		way_statistics_t &e = statistics_chunks[index >> WAY_STATISTICS_CHUNK_SHIFT][index & (WAY_STATISTICS_CHUNK_SIZE-1)];
+		memset( &e, 0, sizeof(way_statistics_t) );
+		e.month = statistics_month;
+#ifdef MULTI_THREAD
+		pthread_mutex_unlock( &way_statistics_mutex );
+#endif
+		// publish only once the entry is complete, other threads may read it any time
+		statistics_index = index;
+		return e;
 	}
-	for(  int type=0;  type<MAX_WAY_TRAVEL_TIMES;  type++  ) {
-		for(  int month=0;  month<MAX_WAY_STAT_MONTHS;  month++  ) {
-			travel_times[month][type] = 0;
+
+	way_statistics_t &e = *const_cast<way_statistics_t *>( get_statistics_entry() );
+	// clear the slots of all months since the last write, at most the whole ring
+	const uint32 months_passed = min( statistics_month - e.month, (uint32)MAX_WAY_STAT_MONTHS );
+	for(  uint32 i = 0;  i < months_passed;  i++  ) {
+		const uint32 slot = (statistics_month - i) % MAX_WAY_STAT_MONTHS;
+		for(  int type = 0;  type < MAX_WAY_STATISTICS;  type++  ) {
+			e.statistics[slot][type] = 0;
+		}
+		for(  int type = 0;  type < MAX_WAY_TRAVEL_TIMES;  type++  ) {
+			e.travel_times[slot][type] = 0;
 		}
 	}
-	creation_month_year = welt->get_timeline_year_month();
+	e.month = statistics_month;
+	return e;
 }
 
 
@@ -370,6 +437,7 @@ void weg_t::init()
 	max_axle_load = 1000;
 	bridge_weight_limit = UINT32_MAX_VALUE;
 	desc = 0;
+	statistics_index = 0;
 	init_statistics();
 	alle_wege.append(this);
 	flags = 0;
@@ -396,6 +464,7 @@ void weg_t::init()
 
 weg_t::~weg_t()
 {
+	release_statistics();
 	if (!welt->is_destroying())
 	{
 #ifdef MULTI_THREAD
@@ -453,15 +522,27 @@ void weg_t::rdwr(loadsave_t *file)
 		}
 	}
 
+	// the statistics are saved as this month and last month
+	sint16 stats[MAX_WAY_STAT_MONTHS][MAX_WAY_STATISTICS];
+	uint32 times[MAX_WAY_STAT_MONTHS][MAX_WAY_TRAVEL_TIMES];
+	for(  uint32 month = 0;  month < MAX_WAY_STAT_MONTHS;  month++  ) {
+		for(  int type = 0;  type < MAX_WAY_STATISTICS;  type++  ) {
+			stats[month][type] = get_month_statistics( month, type );
+		}
+		for(  int type = 0;  type < MAX_WAY_TRAVEL_TIMES;  type++  ) {
+			times[month][type] = get_month_travel_time( month, type );
+		}
+	}
+
 	const uint32 max_stat_types = file->get_extended_version() >= 15 || (file->get_extended_version() == 14 && file->get_extended_revision() >= 19) ? MAX_WAY_STATISTICS : 2;
 
 	for(uint32 type = 0; type < max_stat_types; type++)
 	{
 		for(uint32 month = 0; month < MAX_WAY_STAT_MONTHS; month++)
 		{
-			sint32 w = statistics[month][type];
+			sint32 w = stats[month][type];
 			file->rdwr_long(w);
-			statistics[month][type] = (sint16)w;
+			stats[month][type] = (sint16)w;
 		}
 	}
 
@@ -473,7 +554,7 @@ void weg_t::rdwr(loadsave_t *file)
 		{
 			for (uint32 month = 0; month < MAX_WAY_STAT_MONTHS; month++)
 			{
-				travel_times[month][type] = 0;
+				times[month][type] = 0;
 			}
 		}
 	}
@@ -487,15 +568,15 @@ void weg_t::rdwr(loadsave_t *file)
 
 		for (uint32 month = 0; month < MAX_WAY_STAT_MONTHS; month++)
 		{
-			uint32 w = travel_times[month][WAY_TRAVEL_TIME_ACTUAL];
+			uint32 w = times[month][WAY_TRAVEL_TIME_ACTUAL];
 
 			// Get the now-deprecated stopped vehicles count
 			file->rdwr_long(w);
 
-			travel_times[month][WAY_TRAVEL_TIME_IDEAL] = statistics[month][WAY_STAT_CONVOIS] * mul;
+			times[month][WAY_TRAVEL_TIME_IDEAL] = stats[month][WAY_STAT_CONVOIS] * mul;
 
 			// We'll estimate a stopped vehicle to take twice longer than usual to cross the tile
-			travel_times[month][WAY_TRAVEL_TIME_ACTUAL] = (statistics[month][WAY_STAT_CONVOIS] + (uint32)w) * mul;
+			times[month][WAY_TRAVEL_TIME_ACTUAL] = (stats[month][WAY_STAT_CONVOIS] + (uint32)w) * mul;
 		}
 	}
 
@@ -506,9 +587,34 @@ void weg_t::rdwr(loadsave_t *file)
 		{
 			for (uint32 month = 0; month < MAX_WAY_STAT_MONTHS; month++)
 			{
-				uint32 w = travel_times[month][type];
+				uint32 w = times[month][type];
 				file->rdwr_long(w);
-				travel_times[month][type] = (uint32)w;
+				times[month][type] = (uint32)w;
+			}
+		}
+	}
+
+	if(  file->is_loading()  ) {
+		bool any = false;
+		for(  uint32 month = 0;  month < MAX_WAY_STAT_MONTHS;  month++  ) {
+			for(  int type = 0;  type < MAX_WAY_STATISTICS;  type++  ) {
+				any |= stats[month][type] != 0;
+			}
+			for(  int type = 0;  type < MAX_WAY_TRAVEL_TIMES;  type++  ) {
+				any |= times[month][type] != 0;
+			}
+		}
+		// ways without traffic get no entry in the store
+		if(  any  ) {
+			way_statistics_t &e = get_statistics_for_writing();
+			for(  uint32 month = 0;  month < MAX_WAY_STAT_MONTHS;  month++  ) {
+				const uint32 slot = (statistics_month - month) % MAX_WAY_STAT_MONTHS;
+				for(  int type = 0;  type < MAX_WAY_STATISTICS;  type++  ) {
+					e.statistics[slot][type] = stats[month][type];
+				}
+				for(  int type = 0;  type < MAX_WAY_TRAVEL_TIMES;  type++  ) {
+					e.travel_times[slot][type] = times[month][type];
+				}
 			}
 		}
 	}
@@ -1151,20 +1257,15 @@ void weg_t::check_diagonal()
  */
 void weg_t::new_month()
 {
-	for (int type=0; type<MAX_WAY_STATISTICS; type++) {
-		for (int month=MAX_WAY_STAT_MONTHS-1; month>0; month--) {
-			statistics[month][type] = statistics[month-1][type];
-		}
-		statistics[0][type] = 0;
+	if(  new_month_wear()  ) {
+		renew_or_degrade();
 	}
+}
 
-	for (int type=0; type<MAX_WAY_TRAVEL_TIMES; type++) {
-		for (int month=MAX_WAY_STAT_MONTHS-1; month>0; month--) {
-			travel_times[month][type] = travel_times[month-1][type];
-		}
-		travel_times[0][type] = 0;
-	}
-	wear_way(desc->get_monthly_base_wear());
+
+bool weg_t::new_month_wear()
+{
+	return apply_wear(desc->get_monthly_base_wear());
 }
 
 
@@ -1330,36 +1431,49 @@ uint32 weg_t::get_condition_percent() const
 }
 
 void weg_t::wear_way(uint32 wear)
+{
+	if(apply_wear(wear))
+	{
+		renew_or_degrade();
+	}
+}
+
+bool weg_t::apply_wear(uint32 wear)
 {
 	if(!wear || remaining_wear_capacity == UINT32_MAX_VALUE)
 	{
 		// If ways are defined with UINT32_MAX_VALUE,
 		// this feature is intended to be disabled.
-		return;
+		return false;
 	}
 	if(remaining_wear_capacity > wear)
 	{
 		const uint32 degridation_fraction = welt->get_settings().get_way_degradation_fraction();
 		remaining_wear_capacity -= wear;
-		if(remaining_wear_capacity < desc->get_wear_capacity() / degridation_fraction)
-		{
-			if(!renew())
-			{
-				degrade();
-			}
-		}
+		return remaining_wear_capacity < desc->get_wear_capacity() / degridation_fraction;
 	}
 	else if(!is_degraded())
 	{
 		remaining_wear_capacity = 0;
-		if(!renew())
-		{
-			degrade();
-		}
+		return true;
 	}
+	return false;
+}
+
+void weg_t::renew_or_degrade(bool in_city)
+{
+	if(!renew(in_city))
+	{
+		degrade();
+	}
+}
+
+bool weg_t::is_in_city() const
+{
+	return welt->get_city(get_pos().get_2d()) != NULL;
 }
 
-bool weg_t::renew()
+bool weg_t::renew(bool in_city)
 {
 	if(!replacement_way)
 	{
@@ -1370,12 +1484,12 @@ bool weg_t::renew()
 
 	bool success = false;
 	const sint64 price = desc->get_upgrade_group() == replacement_way->get_upgrade_group() ? replacement_way->get_way_only_cost() : replacement_way->get_value();
-	if(welt->get_city(get_pos().get_2d()) || (owner && (owner->can_afford(price) || owner->is_public_service())))
+	if(in_city || (owner && (owner->can_afford(price) || owner->is_public_service())))
 	{
 		// Unowned ways in cities are assumed to be owned by the city and will be renewed by it.
 		waytype_t wt = replacement_way->get_waytype();
 		const uint16 time = welt->get_timeline_year_month();
-		const bool public_city_road = get_waytype() == road_wt && (owner == NULL || get_owner()->is_public_service()) && welt->get_city(get_pos().get_2d());
+		const bool public_city_road = get_waytype() == road_wt && (owner == NULL || get_owner()->is_public_service()) && in_city;
 		const way_desc_t* latest_city_road = welt->get_settings().get_city_road_type(time);
 		bool is_current = !time || (replacement_way->get_intro_year_month() <= time && time < replacement_way->get_retire_year_month());
 		if (public_city_road && desc != latest_city_road)
@@ -72,6 +72,25 @@ enum travel_times {
 	MAX_WAY_TRAVEL_TIMES
 };
 
+/**
+ * Monthly statistics of a way. They are kept apart from the ways in one
+ * contiguous store, and only for ways which ever saw traffic.
+ * The months form a ring buffer: month m is in slot m % MAX_WAY_STAT_MONTHS.
+ * Slots of past months are only cleared when the entry is next written,
+ * so starting a new month just increments weg_t::statistics_month.
+ */
+struct way_statistics_t
+{
+	uint32 month; ///< weg_t::statistics_month when this entry was last written
+	sint16 statistics[MAX_WAY_STAT_MONTHS][MAX_WAY_STATISTICS];
+	uint32 travel_times[MAX_WAY_STAT_MONTHS][MAX_WAY_TRAVEL_TIMES];
+};
+
+// the store is allocated in chunks, so entries never move while other threads read them
+#define WAY_STATISTICS_CHUNK_SHIFT 12
+#define WAY_STATISTICS_CHUNK_SIZE (1u << WAY_STATISTICS_CHUNK_SHIFT)
+#define MAX_WAY_STATISTICS_CHUNKS 16384
+
 
 
 
@@ -120,15 +139,52 @@ public:
 	static void apply_travel_time_updates();
 	static void clear_travel_time_updates();
 
+	/// starts a new month for the statistics of all ways
+	static void new_statistics_month() { statistics_month++; }
+
 private:
-	/**
-	* array for statistical values
-	* MAX_WAY_STAT_MONTHS: [0] = actual value; [1] = last month value
-	* MAX_WAY_STATISTICS: see #define at top of file
-	*/
-	sint16 statistics[MAX_WAY_STAT_MONTHS][MAX_WAY_STATISTICS];
+	static uint32 statistics_month;
+	static way_statistics_t *statistics_chunks[MAX_WAY_STATISTICS_CHUNKS];
 
-	uint32 travel_times[MAX_WAY_STAT_MONTHS][MAX_WAY_TRAVEL_TIMES];
+	/// index of the statistics in the store, 0 if this way never saw traffic
+	uint32 statistics_index;
+
+	const way_statistics_t *get_statistics_entry() const
+	{
+		return statistics_index ? statistics_chunks[statistics_index >> WAY_STATISTICS_CHUNK_SHIFT] + (statistics_index & (WAY_STATISTICS_CHUNK_SIZE-1)) : NULL;
+	}
+
+	/// allocates the entry if needed and clears the slots of the months passed since it was last written
+	way_statistics_t &start_statistics_month();
+
+	way_statistics_t &get_statistics_for_writing()
+	{
+		way_statistics_t *e = const_cast<way_statistics_t *>( get_statistics_entry() );
+		return e  &&  e->month == statistics_month ? *e : start_statistics_month();
+	}
+
+	/// ring buffer slot of the month @p months_ago (0 = this month), or -1 if nothing was recorded then
+	static sint32 get_statistics_slot(const way_statistics_t *e, uint32 months_ago)
+	{
+		if(  e == NULL  ||  statistics_month - e->month > months_ago  ) {
+			return -1;
+		}
+		return (statistics_month - months_ago) % MAX_WAY_STAT_MONTHS;
+	}
+
+	sint16 get_month_statistics(uint32 months_ago, int type) const
+	{
+		const way_statistics_t *e = get_statistics_entry();
+		const sint32 slot = get_statistics_slot( e, months_ago );
+		return slot < 0 ? 0 : e->statistics[slot][type];
+	}
+
+	uint32 get_month_travel_time(uint32 months_ago, int type) const
+	{
+		const way_statistics_t *e = get_statistics_entry();
+		const sint32 slot = get_statistics_slot( e, months_ago );
+		return slot < 0 ? 0 : e->travel_times[slot][type];
+	}
 
 
 	/**
@@ -174,10 +230,13 @@ private:
 	void init();
 
 	/**
-	* initializes statistic array
+	* clears the statistics
 	*/
 	void init_statistics();
 
+	/// returns the statistics entry to the store
+	void release_statistics();
+
 	/*
 	 * Way constraints for, e.g., loading gauges, types of electrification, etc.
 	 * @author: jamespetts (modified by Bernd Gabriel)
@@ -486,21 +545,38 @@ public:
 	/**
 	* book statistics - is called very often and therefore inline
 	*/
-	void book(int amount, way_statistics type) { statistics[WAY_STAT_THIS_MONTH][type] += amount; }
+	void book(int amount, way_statistics type) { get_statistics_for_writing().statistics[statistics_month % MAX_WAY_STAT_MONTHS][type] += amount; }
 
 	/**
 	* return statistics value
 	* always returns last month's value
 	*/
-	int get_statistics(int type) const { return statistics[WAY_STAT_LAST_MONTH][type]; }
+	int get_statistics(int type) const { return get_month_statistics(WAY_STAT_LAST_MONTH, type); }
 
-	bool is_disused() const { return statistics[WAY_STAT_LAST_MONTH][WAY_STAT_CONVOIS] == 0 && statistics[WAY_STAT_THIS_MONTH][WAY_STAT_CONVOIS] == 0; }
+	bool is_disused() const { return get_month_statistics(WAY_STAT_LAST_MONTH, WAY_STAT_CONVOIS) == 0 && get_month_statistics(WAY_STAT_THIS_MONTH, WAY_STAT_CONVOIS) == 0; }
 
 	/**
 	* new month
 	*/
 	void new_month();
 
+	/**
+	 * The part of new_month() touching only this way: applies the monthly wear.
+	 * May run in parallel for different ways. The statistics are rolled for
+	 * all ways at once by new_statistics_month().
+	 * @return true if the way is worn out, then renew_or_degrade() must follow
+	 */
+	bool new_month_wear();
+
+	/// Renews a worn out way, or degrades it if this is not possible.
+	void renew_or_degrade() { renew_or_degrade( is_in_city() ); }
+
+	/// @param in_city is_in_city(), may be looked up beforehand (and in parallel)
+	void renew_or_degrade(bool in_city);
+
+	/// true if this way is within city limits; the city renews such ways
+	bool is_in_city() const;
+
 	void check_diagonal();
 
 	void count_sign();
@@ -559,13 +635,20 @@ public:
 	 */
 	void wear_way(uint32 wear);
 
+private:
+	/// reduces the remaining wear capacity; true if the way must be renewed or degraded
+	bool apply_wear(uint32 wear);
+
+public:
+
 	void set_replacement_way(const way_desc_t* replacement) { replacement_way = replacement; }
 	const way_desc_t* get_replacement_way() const { return replacement_way; }
 
 	/**
 	 * Renew the way automatically when it is worn out.
+	 * @param in_city is_in_city()
 	 */
-	bool renew();
+	bool renew(bool in_city);
 
 	signal_t* get_signal(ribi_t::ribi direction_of_travel) const;
 
@@ -577,17 +660,18 @@ public:
 	//void increment_traffic_stopped_counter() { statistics[0][WAY_STAT_WAITING] ++; }
 	inline void update_travel_times(uint32 actual, uint32 ideal)
 	{
-		travel_times[WAY_STAT_THIS_MONTH][WAY_TRAVEL_TIME_ACTUAL] += actual;
-		travel_times[WAY_STAT_THIS_MONTH][WAY_TRAVEL_TIME_IDEAL] += ideal;
+		way_statistics_t &e = get_statistics_for_writing();
+		e.travel_times[statistics_month % MAX_WAY_STAT_MONTHS][WAY_TRAVEL_TIME_ACTUAL] += actual;
+		e.travel_times[statistics_month % MAX_WAY_STAT_MONTHS][WAY_TRAVEL_TIME_IDEAL] += ideal;
 	}
 
 	//will return the % ratio of actual to ideal traversal times
 	inline uint32 get_congestion_percentage() const {
-		uint32 combined_ideal = travel_times[WAY_STAT_THIS_MONTH][WAY_TRAVEL_TIME_IDEAL] + travel_times[WAY_STAT_LAST_MONTH][WAY_TRAVEL_TIME_IDEAL];
+		uint32 combined_ideal = get_month_travel_time(WAY_STAT_THIS_MONTH, WAY_TRAVEL_TIME_IDEAL) + get_month_travel_time(WAY_STAT_LAST_MONTH, WAY_TRAVEL_TIME_IDEAL);
 		if(combined_ideal == 0u) {
 			return 0u;
 		}
-		uint32 combined_actual = travel_times[WAY_STAT_THIS_MONTH][WAY_TRAVEL_TIME_ACTUAL] + travel_times[WAY_STAT_LAST_MONTH][WAY_TRAVEL_TIME_ACTUAL];
+		uint32 combined_actual = get_month_travel_time(WAY_STAT_THIS_MONTH, WAY_TRAVEL_TIME_ACTUAL) + get_month_travel_time(WAY_STAT_LAST_MONTH, WAY_TRAVEL_TIME_ACTUAL);
 		if(combined_actual <= combined_ideal) {
 			return 0u;
 		}
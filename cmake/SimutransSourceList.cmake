@@ -231,6 +231,7 @@ target_sources(simutrans-extended PRIVATE
 	io/rdwr/adler32_stream.cc
 	io/rdwr/bzip2_file_rdwr_stream.cc
 	io/rdwr/compare_file_rd_stream.cc
+	io/rdwr/delta_file_rdwr_stream.cc
 	io/rdwr/raw_file_rdwr_stream.cc
 	io/rdwr/rdwr_stream.cc
 	io/rdwr/zlib_file_rdwr_stream.cc
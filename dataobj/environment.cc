@@ -66,6 +66,7 @@ sint32 env_t::additional_client_frames_behind = 4;
 sint32 env_t::network_frames_per_step = 4;
 uint32 env_t::server_sync_steps_between_checks = 24;
 bool env_t::pause_server_no_clients = false;
+bool env_t::server_snapshot_join = false;
 bool env_t::server_runs_background_tasks_when_paused = false;
 
 std::string env_t::nickname = "";
@@ -136,6 +137,7 @@ sint32 env_t::intercity_road_length;
 plainstring env_t::river_type[10];
 uint8 env_t::river_types;
 sint32 env_t::autosave;
+bool env_t::autosave_in_background;
 uint32 env_t::fps;
 uint32 env_t::ff_fps;
 sint16 env_t::max_acceleration;
@@ -272,6 +274,7 @@ void env_t::init()
 
 	// autosave every x months (0=off)
 	autosave = 0;
+	autosave_in_background = false;
 
 	reload_and_save_on_quit = true;
 
@@ -143,6 +143,11 @@ public:
 	/// pause server if no client connected
 	static bool pause_server_no_clients;
 
+	/// when true, only a joining client receives a snapshot of the running game;
+	/// the other clients keep playing instead of saving and reloading
+	/// @see nwc_sync_t::do_command()
+	static bool server_snapshot_join;
+
 	/// The server will run the path explorer and private car route finder when paused if this is set.
 	static bool server_runs_background_tasks_when_paused;
 
@@ -476,6 +481,10 @@ public:
 	/// do autosave every month?
 	static sint32 autosave;
 
+	/// autosave from a forked copy of the game while it continues (not on Windows)
+	/// this also allows autosaves on a server
+	static bool autosave_in_background;
+
 
 	/**
 	 * @name Midi/sound options
@@ -21,6 +21,7 @@
 #include "../utils/simstring.h"
 
 #include "../io/rdwr/bzip2_file_rdwr_stream.h"
+#include "../io/rdwr/delta_file_rdwr_stream.h"
 #include "../io/rdwr/raw_file_rdwr_stream.h"
 #include "../io/rdwr/zlib_file_rdwr_stream.h"
 #if USE_ZSTD
@@ -195,6 +196,7 @@ void saving_finalize()
 loadsave_t::mode_t loadsave_t::save_mode = bzip2;	// default to use for saving
 loadsave_t::mode_t loadsave_t::autosave_mode = zipped;	// default to use for autosaving
 int loadsave_t::save_level = 6;
+bool loadsave_t::single_threaded = false;
 int loadsave_t::autosave_level = 1;
 
 
@@ -222,7 +224,7 @@ loadsave_t::~loadsave_t()
 void loadsave_t::set_buffered(bool enable)
 {
 	if(  enable  ) {
-		if(  !buffered  ) {
+		if(  !buffered  &&  !single_threaded  ) {
 			buffered = true;
 			curr_buff = 0;
 			buff[0].pos = buff[1].pos = 0;
@@ -332,6 +334,12 @@ loadsave_t::file_status_t loadsave_t::rd_open(const char *filename_utf8)
 			mode |= zipped;
 			stream = new zlib_file_rdwr_stream_t(filename_utf8, false, 0); break;
 
+		case file_info_t::TYPE_XML_DELTA:
+			mode = xml;
+			// fallthrough
+		case file_info_t::TYPE_DELTA:
+			stream = new delta_file_rdwr_stream_t(filename_utf8, false); break;
+
 		case file_info_t::TYPE_XML:
 			mode = xml;
 			// fallthrough
@@ -401,7 +409,7 @@ void loadsave_t::rdwr_string(std::string &s)
 
 
 loadsave_t::file_status_t loadsave_t::wr_open( const char *filename_utf8, mode_t m, int level, const char *pak_extension,
-	const char *savegame_version, const char *savegame_version_ex, const char * )
+	const char *savegame_version, const char *savegame_version_ex, const char *, rdwr_stream_t *tee, const char *delta_base )
 {
 	mode = m;
 	close();
@@ -414,18 +422,31 @@ loadsave_t::file_status_t loadsave_t::wr_open( const char *filename_utf8, mode_t
 	}
 #endif
 
+	if(  tee  &&  (mode & bzip2)  ) {
+		// bzip2 writes to the file itself, hence it cannot pass its output on
+		mode &= ~bzip2;
+		mode |= zipped;
+	}
+
 	assert(stream == NULL);
 
-	switch (mode & ~xml) {
+	if(  delta_base  ) {
+		assert(tee == NULL);
+		mode &= xml;
+		stream = new delta_file_rdwr_stream_t(filename_utf8, true, delta_base);
+	}
+	else {
+		switch (mode & ~xml) {
 #if USE_ZSTD
-		case zstd: stream = new zstd_file_rdwr_stream_t(filename_utf8, true, level); break;
+			case zstd: stream = new zstd_file_rdwr_stream_t(filename_utf8, true, level, tee); break;
 #endif
-		case bzip2:  stream = new bzip2_file_rdwr_stream_t(filename_utf8, true);       break;
-		case zipped: stream = new zlib_file_rdwr_stream_t(filename_utf8, true, level); break;
-		case binary: stream = new raw_file_rdwr_stream_t(filename_utf8, true);         break;
-		default:
-			dbg->error("loadsave_t::wr_open", "Unsupported save file compression");
-			return FILE_STATUS_ERR_UNSUPPORTED_COMPRESSION;
+			case bzip2:  stream = new bzip2_file_rdwr_stream_t(filename_utf8, true);            break;
+			case zipped: stream = new zlib_file_rdwr_stream_t(filename_utf8, true, level, tee); break;
+			case binary: stream = new raw_file_rdwr_stream_t(filename_utf8, true, tee);         break;
+			default:
+				dbg->error("loadsave_t::wr_open", "Unsupported save file compression");
+				return FILE_STATUS_ERR_UNSUPPORTED_COMPRESSION;
+		}
 	}
 
 	if (stream->get_status() != rdwr_stream_t::STATUS_OK) {
@@ -99,6 +99,8 @@ protected:
 
 	bool is_xml() const { return mode&xml; }
 
+	static bool single_threaded;
+
 public:
 	static mode_t save_mode;     ///< default to use for saving
 	static mode_t autosave_mode; ///< default to use for autosaves and network mode client temp saves
@@ -119,7 +121,13 @@ public:
 	~loadsave_t();
 
 	file_status_t rd_open(const char *filename);
-	file_status_t wr_open(const char *filename, mode_t mode, int level, const char *pak_extension, const char *savegame_version, const char *savegame_version_ex, const char *savegame_revision_ex);
+	/**
+	 * @param tee if given, the file data is also written to this stream while saving
+	 *            (bzip2 is replaced by zipped then)
+	 * @param delta_base if given, only the difference to this savegame is written
+	 *            (the compression of @p mode is ignored then, @p tee must be NULL)
+	 */
+	file_status_t wr_open(const char *filename, mode_t mode, int level, const char *pak_extension, const char *savegame_version, const char *savegame_version_ex, const char *savegame_revision_ex, rdwr_stream_t *tee = NULL, const char *delta_base = NULL);
 	const char *close();
 
 	static void set_savemode(mode_t mode) { save_mode = mode; }
@@ -133,6 +141,9 @@ public:
 	bool is_eof();
 
 	void set_buffered(bool enable);
+
+	/// in a process which must not start threads (like a forked child) saving is unbuffered
+	static void set_single_threaded(bool yes) { single_threaded = yes; }
 	unsigned get_buf_pos(int buf_num) const { return buff[buf_num].pos; }
 	bool is_loading() const { return stream && !stream->is_writing(); }
 	bool is_saving() const { return stream && stream->is_writing(); }
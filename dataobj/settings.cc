@@ -2133,6 +2133,7 @@ void settings_t::parse_simuconf( tabfile_t& simuconf, sint16& disp_width, sint16
 	env_t::server_sync_steps_between_checks = contents.get_int_clamped( "server_frames_between_checks",    env_t::server_sync_steps_between_checks, 1, INT_MAX );
 
 	env_t::pause_server_no_clients          = contents.get_int( "pause_server_no_clients",  env_t::pause_server_no_clients  ) != 0;
+	env_t::server_snapshot_join             = contents.get_int( "server_snapshot_join",     env_t::server_snapshot_join     ) != 0;
 	env_t::server_save_game_on_quit         = contents.get_int( "server_save_game_on_quit", env_t::server_save_game_on_quit ) != 0;
 	env_t::reload_and_save_on_quit          = contents.get_int( "reload_and_save_on_quit",  env_t::reload_and_save_on_quit  ) != 0;
 	env_t::server_runs_background_tasks_when_paused = contents.get_int("server_runs_background_tasks_when_paused", env_t::server_runs_background_tasks_when_paused);
@@ -2368,6 +2369,7 @@ void settings_t::parse_simuconf( tabfile_t& simuconf, sint16& disp_width, sint16
 	}
 
 	env_t::autosave = contents.get_int_clamped( "autosave", env_t::autosave, 0, INT_MAX );
+	env_t::autosave_in_background = contents.get_int( "autosave_in_background", env_t::autosave_in_background ) != 0;
 
 	// routing stuff
 	max_route_steps        = contents.get_int_clamped( "max_route_steps",        max_route_steps,        0, INT_MAX );
@@ -26,7 +26,7 @@ void bridge_reader_t::register_obj(obj_desc_t *&data)
 }
 
 
-obj_desc_t * bridge_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t * bridge_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	// DBG_DEBUG("bridge_reader_t::read_node()", "called");
 	ALLOCA(char, desc_buf, node.size);
@@ -34,7 +34,7 @@ obj_desc_t * bridge_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 	bridge_desc_t *desc = new bridge_desc_t();
 
 	// Read data
-	fread(desc_buf, node.size, 1, fp);
+	memcpy(desc_buf, data, node.size);
 
 	char * p = desc_buf;
 
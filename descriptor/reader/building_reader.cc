@@ -30,14 +30,14 @@ struct old_btyp
 };
 
 
-obj_desc_t * tile_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t * tile_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	ALLOCA(char, desc_buf, node.size);
 
 	building_tile_desc_t *desc = new building_tile_desc_t();
 
 	// Read data
-	fread(desc_buf, node.size, 1, fp);
+	memcpy(desc_buf, data, node.size);
 
 	char * p = desc_buf;
 
@@ -213,14 +213,14 @@ bool building_reader_t::successfully_loaded() const
 }
 
 
-obj_desc_t * building_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t * building_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	ALLOCA(char, desc_buf, node.size);
 
 	building_desc_t *desc = new building_desc_t();
 
 	// Read data
-	fread(desc_buf, node.size, 1, fp);
+	memcpy(desc_buf, data, node.size);
 
 	char * p = desc_buf;
 	// old versions of PAK files have no version stamp.
@@ -36,14 +36,14 @@ bool citycar_reader_t::successfully_loaded() const
 }
 
 
-obj_desc_t * citycar_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t * citycar_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	ALLOCA(char, desc_buf, node.size);
 
 	citycar_desc_t *desc = new citycar_desc_t();
 
 	// Read data
-	fread(desc_buf, node.size, 1, fp);
+	memcpy(desc_buf, data, node.size);
 
 	char * p = desc_buf;
 
@@ -28,7 +28,7 @@ public:
 	char const* get_type_name() const OVERRIDE { return "citycar"; }
 
 	/// @copydoc obj_reader_t::read_node
-	obj_desc_t *read_node(FILE *fp, obj_node_info_t &node) OVERRIDE;
+	obj_desc_t *read_node(const char *data, obj_node_info_t &node) OVERRIDE;
 };
 
 #endif
@@ -33,14 +33,14 @@ uint16 rescale_probability(const uint16 p)
 }
 
 
-obj_desc_t *factory_field_class_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t *factory_field_class_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	ALLOCA(char, desc_buf, node.size);
 
 	field_class_desc_t *desc = new field_class_desc_t();
 
 	// Read data
-	fread(desc_buf, node.size, 1, fp);
+	memcpy(desc_buf, data, node.size);
 	char * p = desc_buf;
 
 	uint16 v = decode_uint16(p);
@@ -65,14 +65,14 @@ obj_desc_t *factory_field_class_reader_t::read_node(FILE *fp, obj_node_info_t &n
 }
 
 
-obj_desc_t *factory_field_group_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t *factory_field_group_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	ALLOCA(char, desc_buf, node.size);
 
 	field_group_desc_t *desc = new field_group_desc_t();
 
 	// Read data
-	fread(desc_buf, node.size, 1, fp);
+	memcpy(desc_buf, data, node.size);
 	char * p = desc_buf;
 
 	uint16 v = decode_uint16(p);
@@ -159,14 +159,14 @@ void factory_field_group_reader_t::register_obj(obj_desc_t *&data)
 	}
 }
 
-obj_desc_t *factory_smoke_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t *factory_smoke_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	ALLOCA(char, desc_buf, node.size);
 
 	smoke_desc_t *desc = new smoke_desc_t();
 
 	// Read data
-	fread(desc_buf, node.size, 1, fp);
+	memcpy(desc_buf, data, node.size);
 	char * p = desc_buf;
 
 	sint16 x = decode_sint16(p);
@@ -185,7 +185,7 @@ obj_desc_t *factory_smoke_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 }
 
 
-obj_desc_t *factory_supplier_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t *factory_supplier_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	// DBG_DEBUG("factory_product_reader_t::read_node()", "called");
 	ALLOCA(char, desc_buf, node.size);
@@ -193,7 +193,7 @@ obj_desc_t *factory_supplier_reader_t::read_node(FILE *fp, obj_node_info_t &node
 	factory_supplier_desc_t *desc = new factory_supplier_desc_t();
 
 	// Read data
-	fread(desc_buf, node.size, 1, fp);
+	memcpy(desc_buf, data, node.size);
 	char * p = desc_buf;
 
 	// old versions of PAK files have no version stamp.
@@ -224,7 +224,7 @@ obj_desc_t *factory_supplier_reader_t::read_node(FILE *fp, obj_node_info_t &node
 }
 
 
-obj_desc_t *factory_product_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t *factory_product_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	// DBG_DEBUG("factory_product_reader_t::read_node()", "called");
 	ALLOCA(char, desc_buf, node.size);
@@ -232,7 +232,7 @@ obj_desc_t *factory_product_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 	factory_product_desc_t *desc = new factory_product_desc_t();
 
 	// Read data
-	fread(desc_buf, node.size, 1, fp);
+	memcpy(desc_buf, data, node.size);
 
 	char * p = desc_buf;
 
@@ -258,7 +258,7 @@ obj_desc_t *factory_product_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 }
 
 
-obj_desc_t *factory_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t *factory_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	// DBG_DEBUG("factory_reader_t::read_node()", "called");
 	ALLOCA(char, desc_buf, node.size);
@@ -266,7 +266,7 @@ obj_desc_t *factory_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 	factory_desc_t *desc = new factory_desc_t();
 
 	// Read data
-	fread(desc_buf, node.size, 1, fp);
+	memcpy(desc_buf, data, node.size);
 
 	desc->sound_id = NO_SOUND;
 	desc->sound_interval = 10000u;
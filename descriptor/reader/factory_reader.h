@@ -24,7 +24,7 @@ public:
 	static factory_field_class_reader_t *instance() { return &the_instance; }
 
 	/// @copydoc obj_reader_t::read_node
-	obj_desc_t *read_node(FILE *fp, obj_node_info_t &node) OVERRIDE;
+	obj_desc_t *read_node(const char *data, obj_node_info_t &node) OVERRIDE;
 
 	obj_type get_type() const OVERRIDE { return obj_ffldclass; }
 	char const* get_type_name() const OVERRIDE { return "factory field class"; }
@@ -47,7 +47,7 @@ public:
 	static factory_field_group_reader_t *instance() { return &the_instance; }
 
 	/// @copydoc obj_reader_t::read_node
-	obj_desc_t *read_node(FILE *fp, obj_node_info_t &node) OVERRIDE;
+	obj_desc_t *read_node(const char *data, obj_node_info_t &node) OVERRIDE;
 
 	obj_type get_type() const OVERRIDE { return obj_ffield; }
 	char const* get_type_name() const OVERRIDE { return "factory field"; }
@@ -63,7 +63,7 @@ public:
 	static factory_smoke_reader_t*instance() { return &the_instance; }
 
 	/// @copydoc obj_reader_t::read_node
-	obj_desc_t* read_node(FILE *fp, obj_node_info_t &node) OVERRIDE;
+	obj_desc_t* read_node(const char *data, obj_node_info_t &node) OVERRIDE;
 
 	obj_type get_type() const OVERRIDE { return obj_fsmoke; }
 	char const* get_type_name() const OVERRIDE { return "factory smoke"; }
@@ -78,7 +78,7 @@ public:
 	static factory_supplier_reader_t*instance() { return &the_instance; }
 
 	/// @copydoc obj_reader_t::read_node
-	obj_desc_t *read_node(FILE *fp, obj_node_info_t &node) OVERRIDE;
+	obj_desc_t *read_node(const char *data, obj_node_info_t &node) OVERRIDE;
 
 	obj_type get_type() const OVERRIDE { return obj_fsupplier; }
 	char const* get_type_name() const OVERRIDE { return "factory supplier"; }
@@ -93,7 +93,7 @@ public:
 	static factory_product_reader_t*instance() { return &the_instance; }
 
 	/// @copydoc obj_reader_t::read_node
-	obj_desc_t *read_node(FILE *fp, obj_node_info_t &node) OVERRIDE;
+	obj_desc_t *read_node(const char *data, obj_node_info_t &node) OVERRIDE;
 
 	obj_type get_type() const OVERRIDE { return obj_fproduct; }
 	char const* get_type_name() const OVERRIDE { return "factory product"; }
@@ -116,7 +116,7 @@ public:
 	static factory_reader_t*instance() { return &the_instance; }
 
 	/// @copydoc obj_reader_t::read_node
-	obj_desc_t *read_node(FILE *fp, obj_node_info_t &node) OVERRIDE;
+	obj_desc_t *read_node(const char *data, obj_node_info_t &node) OVERRIDE;
 
 	obj_type get_type() const OVERRIDE { return obj_factory; }
 	char const* get_type_name() const OVERRIDE { return "factory"; }
@@ -34,7 +34,7 @@ bool goods_reader_t::successfully_loaded() const
 }
 
 
-obj_desc_t * goods_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t * goods_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	ALLOCA(char, desc_buf, node.size);
 
@@ -46,7 +46,7 @@ obj_desc_t * goods_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 	desc->color = 255;
 
 	// Read data
-	fread(desc_buf, node.size, 1, fp);
+	memcpy(desc_buf, data, node.size);
 
 	char * p = desc_buf;
 
@@ -23,7 +23,7 @@ bool ground_reader_t::successfully_loaded() const
 }
 
 
-obj_desc_t* ground_reader_t::read_node(FILE*, obj_node_info_t& info)
+obj_desc_t* ground_reader_t::read_node(const char*, obj_node_info_t& info)
 {
 	return obj_reader_t::read_node<ground_desc_t>(info);
 }
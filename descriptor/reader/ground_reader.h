@@ -24,7 +24,7 @@ public:
 	static ground_reader_t*instance() { return &the_instance; }
 
 	/// @copydoc obj_reader_t::read_node
-	obj_desc_t *read_node(FILE *fp, obj_node_info_t &node) OVERRIDE;
+	obj_desc_t *read_node(const char *data, obj_node_info_t &node) OVERRIDE;
 
 	obj_type get_type() const OVERRIDE { return obj_ground; }
 	char const* get_type_name() const OVERRIDE { return "ground"; }
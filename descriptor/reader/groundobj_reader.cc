@@ -40,14 +40,14 @@ bool groundobj_reader_t::successfully_loaded() const
 }
 
 
-obj_desc_t * groundobj_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t * groundobj_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	ALLOCA(char, desc_buf, node.size);
 
 	groundobj_desc_t *desc = new groundobj_desc_t();
 
 	// Read data
-	fread(desc_buf, node.size, 1, fp);
+	memcpy(desc_buf, data, node.size);
 
 	char * p = desc_buf;
 
@@ -24,13 +24,18 @@
 #define skip_reading_pixels_if_no_graphics goto adjust_image
 #endif
 
-obj_desc_t *image_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t *image_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
-	ALLOCA(char, desc_buf, node.size);
+	return read_decoded_node(decode_node(data, node));
+}
+
+
+obj_desc_t *image_reader_t::decode_node(const char *data, obj_node_info_t &node) const
+{
+	// only read from, so no copy (which may not fit on the stack of a loader thread)
+	char *desc_buf = const_cast<char *>(data);
 	image_t* desc=NULL;
 
-	// Read data
-	fread(desc_buf, node.size, 1, fp);
 	char * p = desc_buf+6;
 
 	// always zero in old version, since length was always less than 65535
@@ -63,12 +68,12 @@ obj_desc_t *image_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 
 		if (desc->h > 0) {
 			for (uint i = 0; i < desc->len; i++) {
-				uint16 data = decode_uint16(p);
-				if(data>=0x8000u  &&  data<=0x800Fu) {
+				uint16 pixel = decode_uint16(p);
+				if(pixel>=0x8000u  &&  pixel<=0x800Fu) {
 					// player color offset changed
-					data ++;
+					pixel ++;
 				}
-				*dest++ = data;
+				*dest++ = pixel;
 			}
 		}
 	}
@@ -162,6 +167,14 @@ adjust_image:
 		}
 	}
 
+	return desc;
+}
+
+
+obj_desc_t *image_reader_t::read_decoded_node(obj_desc_t *decoded)
+{
+	image_t *desc = static_cast<image_t *>(decoded);
+
 	if (desc->len != 0) {
 		// get the adler hash (since we have zlib on board anyway ... )
 		bool do_register_image = true;
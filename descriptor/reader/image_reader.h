@@ -20,7 +20,13 @@ public:
 	obj_type get_type() const OVERRIDE { return obj_image; }
 	char const* get_type_name() const OVERRIDE { return "image"; }
 
-	obj_desc_t* read_node(FILE*, obj_node_info_t&) OVERRIDE;
+	obj_desc_t* read_node(const char*, obj_node_info_t&) OVERRIDE;
+
+	/// Decodes the pixels, which is thread safe
+	obj_desc_t* decode_node(const char*, obj_node_info_t&) const OVERRIDE;
+
+	/// Merges duplicates and registers the image
+	obj_desc_t* read_decoded_node(obj_desc_t*) OVERRIDE;
 };
 
 #endif
@@ -12,14 +12,14 @@
 #include "../obj_node_info.h"
 
 
-obj_desc_t * imagelist2d_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t * imagelist2d_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	ALLOCA(char, desc_buf, node.size);
 
 	image_array_t *desc = new image_array_t();
 
 	// Read data
-	fread(desc_buf, node.size, 1, fp);
+	memcpy(desc_buf, data, node.size);
 	char * p = desc_buf;
 
 	desc->count = decode_uint16(p);
@@ -23,11 +23,16 @@
 
 #include "../../utils/searchfolder.h"
 #include "../../utils/simstring.h"
+#ifdef MULTI_THREAD
+#include "../../utils/simthread.h"
+#endif
 
 #include "../../tpl/inthashtable_tpl.h"
 #include "../../tpl/ptrhashtable_tpl.h"
 #include "../../tpl/stringhashtable_tpl.h"
+#include "../../tpl/vector_tpl.h"
 #include "../../simdebug.h"
+#include "../../simmem.h"
 
 #include "../obj_desc.h"
 #include "../obj_node_info.h"
@@ -35,6 +40,41 @@
 #include "obj_reader.h"
 
 
+/// a node of a pak file in memory
+struct obj_reader_t::pak_node_t
+{
+	obj_node_info_t info;
+	const char *data;
+	obj_desc_t *decoded;  ///< from decode_node() or NULL
+	pak_node_t *children;
+
+	pak_node_t() : data(NULL), decoded(NULL), children(NULL) {}
+	~pak_node_t() { delete [] children; }
+};
+
+
+struct obj_reader_t::pak_file_t
+{
+	const char *name;
+	char *buf;  ///< the whole file
+	size_t size;
+	pak_node_t root;
+	bool ok;  ///< root was parsed
+
+	pak_file_t() : name(NULL), buf(NULL), size(0), ok(false) {}
+	~pak_file_t() { free(buf); }
+};
+
+
+struct obj_reader_t::parse_job_t
+{
+	pak_file_t *paks;
+	uint32 count;
+	uint32 first;
+	uint32 step;
+};
+
+
 obj_reader_t::obj_map*                                        obj_reader_t::obj_reader;
 inthashtable_tpl<obj_type, stringhashtable_tpl<obj_desc_t*, N_BAGS_LARGE>, N_BAGS_LARGE> obj_reader_t::loaded;
 obj_reader_t::unresolved_map                                  obj_reader_t::unresolved;
@@ -147,12 +187,35 @@ DBG_MESSAGE("obj_reader_t::load()","big logo %p", skinverwaltung_t::biglogosymbo
 
 DBG_MESSAGE("obj_reader_t::load()", "reading from '%s'", name.c_str());
 
-		uint n = 0;
-		FORX(searchfolder_t, const& i, find, ++n) {
-			read_file(i);
-			if ((n & step) == 0 && drawing) {
-				ls.set_progress(n);
+		// batches of files are read and decoded in parallel, but registered in order,
+		// so the result (and the pakset checksum) does not depend on the threads
+		vector_tpl<const char *> names;
+		FOR(searchfolder_t, const& i, find) {
+			names.append(i);
+		}
+		uint32 batch_size = 16;
+#ifdef MULTI_THREAD
+		batch_size *= env_t::num_threads > 1 ? env_t::num_threads : 1;
+#endif
+		for(  uint32 first = 0;  first < names.get_count();  first += batch_size  ) {
+			const uint32 count = min(batch_size, names.get_count() - first);
+			pak_file_t *batch = new pak_file_t[count];
+			for(  uint32 j = 0;  j < count;  j++  ) {
+				batch[j].name = names[first + j];
+			}
+			parse_paks(batch, count);
+
+			for(  uint32 j = 0;  j < count;  j++  ) {
+				if(  batch[j].ok  ) {
+					obj_desc_t *data = NULL;
+					read_nodes(batch[j].root, data, 0);
+				}
+				const uint32 n = first + j;
+				if ((n & step) == 0 && drawing) {
+					ls.set_progress(n);
+				}
 			}
+			delete [] batch;
 		}
 		ls.set_progress(max);
 
@@ -167,112 +230,190 @@ void obj_reader_t::read_file(const char *name)
 	// added trace
 	DBG_DEBUG("obj_reader_t::read_file()", "filename='%s'", name);
 
-	if (FILE* const fp = dr_fopen(name, "rb")) {
-		sint32 n = 0;
+	pak_file_t pak;
+	pak.name = name;
+	if(  parse_pak(pak)  ) {
+		obj_desc_t *data = NULL;
+		read_nodes(pak.root, data, 0);
+	}
+}
 
-		// This is the normal header reading code
-		int c;
-		do {
-			c = fgetc(fp);
-			n ++;
-		} while(!feof(fp) && c != 0x1a);
 
-		if(feof(fp)) {
-			dbg->error("obj_reader_t::read_file()", "unexpected end of file after %d bytes while reading '%s'!",n, name);
+bool obj_reader_t::parse_pak(pak_file_t &pak)
+{
+	if(  !pak.buf  ) {
+		FILE *fp = dr_fopen(pak.name, "rb");
+		long len = -1;
+		if(  fp  &&  fseek(fp, 0, SEEK_END) == 0  ) {
+			len = ftell(fp);
+			rewind(fp);
+		}
+		if(  len >= 0  ) {
+			pak.size = (size_t)len;
+			pak.buf = MALLOCN(char, pak.size + 1);
+			if(  fread(pak.buf, 1, pak.size, fp) != pak.size  ) {
+				len = -1;
+			}
+		}
+		if(  fp  ) {
+			fclose(fp);
 		}
-		else {
-//			DBG_DEBUG("obj_reader_t::read_file()", "skipped %d header bytes", n);
+		if(  len < 0  ) {
+			dbg->error("obj_reader_t::read_file()", "reading '%s' failed!", pak.name);
+			return false;
 		}
+	}
 
-		// Compiled Version
-		uint32 version = 0;
-		char dummy[4], *p;
-		p = dummy;
+	// This is the normal header reading code
+	char *p = pak.buf;
+	const char *end = pak.buf + pak.size;
+	while(  p < end  &&  *p != 0x1a  ) {
+		p++;
+	}
+	if(  end - p < 5  ) {
+		dbg->error("obj_reader_t::read_file()", "unexpected end of file after %d bytes while reading '%s'!", (int)pak.size, pak.name);
+		return false;
+	}
+	p++;
 
-		n = fread(dummy, 4, 1, fp);
-		version = decode_uint32(p);
+	// Compiled Version
+	const uint32 version = decode_uint32(p);
 
-		DBG_DEBUG("obj_reader_t::read_file()", "read %d blocks, file version is %x", n, version);
+	DBG_DEBUG("obj_reader_t::read_file()", "file version is %x", version);
 
-		if(version <= COMPILER_VERSION_CODE) {
-			obj_desc_t *data = NULL;
-			read_nodes(fp, data, 0, version );
-		}
-		else {
-			DBG_DEBUG("obj_reader_t::read_file()","version of '%s' is too old, %d instead of %d", name, version, COMPILER_VERSION_CODE );
+	if(version > COMPILER_VERSION_CODE) {
+		DBG_DEBUG("obj_reader_t::read_file()","version of '%s' is too old, %d instead of %d", pak.name, version, COMPILER_VERSION_CODE );
+		return false;
+	}
+	if(  !parse_nodes(p, end, version, pak.root)  ) {
+		dbg->error("obj_reader_t::read_file()", "unexpected end of file while reading '%s'!", pak.name);
+		return false;
+	}
+	decode_nodes(pak.root);
+	pak.ok = true;
+	return true;
+}
+
+
+bool obj_reader_t::parse_nodes(char *&p, const char *end, uint32 version, pak_node_t &node)
+{
+	if(  end - p < OBJ_NODE_INFO_SIZE  ) {
+		return false;
+	}
+	node.info.type     = decode_uint32(p);
+	node.info.children = decode_uint16(p);
+	node.info.size     = decode_uint16(p);
+	// can have larger records
+	if (version != COMPILER_VERSION_CODE_11 && node.info.size == LARGE_RECORD_SIZE) {
+		if(  end - p < EXT_OBJ_NODE_INFO_SIZE - OBJ_NODE_INFO_SIZE  ) {
+			return false;
 		}
-		fclose(fp);
+		node.info.size = decode_uint32(p);
 	}
-	else {
-		dbg->error("obj_reader_t::read_file()", "reading '%s' failed!", name);
+	if(  (size_t)(end - p) < node.info.size  ) {
+		return false;
+	}
+	node.data = p;
+	p += node.info.size;
+
+	if(  node.info.children > 0  ) {
+		node.children = new pak_node_t[node.info.children];
+		for(  uint16 i = 0;  i < node.info.children;  i++  ) {
+			if(  !parse_nodes(p, end, version, node.children[i])  ) {
+				return false;
+			}
+		}
 	}
+	return true;
 }
 
 
-static void read_node_info(obj_node_info_t& node, FILE* const f, uint32 const version)
+void obj_reader_t::decode_nodes(pak_node_t &node)
 {
-	char data[EXT_OBJ_NODE_INFO_SIZE];
+	// the children of unknown nodes are skipped by read_nodes(), so do not decode them either
+	obj_reader_t *reader = obj_reader->get(static_cast<obj_type>(node.info.type));
+	if(  reader  ) {
+		node.decoded = reader->decode_node(node.data, node.info);
+		for(  uint16 i = 0;  i < node.info.children;  i++  ) {
+			decode_nodes(node.children[i]);
+		}
+	}
+}
 
-	char* p = data;
-	fread(p, OBJ_NODE_INFO_SIZE, 1, f);
-	node.type     = decode_uint32(p);
-	node.children = decode_uint16(p);
-	node.size     = decode_uint16(p);
-	// can have larger records
-	if (version != COMPILER_VERSION_CODE_11 && node.size == LARGE_RECORD_SIZE) {
-		fread(p, sizeof(data) - OBJ_NODE_INFO_SIZE, 1, f);
-		node.size = decode_uint32(p);
+
+void *obj_reader_t::parse_paks_thread(void *ptr)
+{
+	parse_job_t *job = (parse_job_t *)ptr;
+	for(  uint32 i = job->first;  i < job->count;  i += job->step  ) {
+		parse_pak(job->paks[i]);
 	}
+	return NULL;
 }
 
 
-void obj_reader_t::read_nodes(FILE* fp, obj_desc_t*& data, int register_nodes, uint32 version )
+void obj_reader_t::parse_paks(pak_file_t *paks, uint32 count)
 {
-	obj_node_info_t node;
-	read_node_info(node, fp, version);
+	parse_job_t job = { paks, count, 0, 1 };
+#ifdef MULTI_THREAD
+	const uint32 num_threads = min(count, (uint32)max(1, (int)env_t::num_threads));
+	if(  num_threads > 1  ) {
+		parse_job_t *jobs = new parse_job_t[num_threads];
+		pthread_t *threads = new pthread_t[num_threads];
+		bool *started = new bool[num_threads];
+		for(  uint32 t = 0;  t < num_threads;  t++  ) {
+			jobs[t] = job;
+			jobs[t].first = t;
+			jobs[t].step = num_threads;
+			started[t] = t > 0  &&  pthread_create(&threads[t], NULL, parse_paks_thread, &jobs[t]) == 0;
+		}
+		parse_paks_thread(&jobs[0]);
+		for(  uint32 t = 1;  t < num_threads;  t++  ) {
+			if(  started[t]  ) {
+				pthread_join(threads[t], NULL);
+			}
+			else {
+				parse_paks_thread(&jobs[t]);
+			}
+		}
+		delete [] started;
+		delete [] threads;
+		delete [] jobs;
+		return;
+	}
+#endif
+	parse_paks_thread(&job);
+}
+
 
-	obj_reader_t *reader = obj_reader->get(static_cast<obj_type>(node.type));
+void obj_reader_t::read_nodes(pak_node_t &node, obj_desc_t*& data, int register_nodes)
+{
+	obj_reader_t *reader = obj_reader->get(static_cast<obj_type>(node.info.type));
 	if(reader) {
 
-//DBG_DEBUG("obj_reader_t::read_nodes()","Reading %.4s-node of length %d with '%s'", reinterpret_cast<const char *>(&node.type), node.size, reader->get_type_name());
-		data = reader->read_node(fp, node);
-		if (node.children != 0) {
-			data->children = new obj_desc_t*[node.children];
-			for (int i = 0; i < node.children; i++) {
-				read_nodes(fp, data->children[i], register_nodes + 1, version);
+//DBG_DEBUG("obj_reader_t::read_nodes()","Reading %.4s-node of length %d with '%s'", reinterpret_cast<const char *>(&node.info.type), node.info.size, reader->get_type_name());
+		data = node.decoded ? reader->read_decoded_node(node.decoded) : reader->read_node(node.data, node.info);
+		node.decoded = NULL;
+		if (node.info.children != 0) {
+			data->children = new obj_desc_t*[node.info.children];
+			for (int i = 0; i < node.info.children; i++) {
+				read_nodes(node.children[i], data->children[i], register_nodes + 1);
 			}
 		}
 
 //DBG_DEBUG("obj_reader_t","registering with '%s'", reader->get_type_name());
-		if(register_nodes<2  ||  node.type!=obj_cursor) {
+		if(register_nodes<2  ||  node.info.type!=obj_cursor) {
 			// since many buildings are with cursors that do not need registration
 			reader->register_obj(data);
 		}
 	}
 	else {
 		// no reader found ...
-		dbg->warning("obj_reader_t::read_nodes()","skipping unknown %.4s-node\n",reinterpret_cast<const char *>(&node.type));
-		fseek(fp, node.size, SEEK_CUR);
-		for(int i = 0; i < node.children; i++) {
-			skip_nodes(fp,version);
-		}
+		dbg->warning("obj_reader_t::read_nodes()","skipping unknown %.4s-node\n",reinterpret_cast<const char *>(&node.info.type));
 		data = NULL;
 	}
 }
 
 
-void obj_reader_t::skip_nodes(FILE *fp,uint32 version)
-{
-	obj_node_info_t node;
-	read_node_info(node, fp, version);
-
-	fseek(fp, node.size, SEEK_CUR);
-	for(int i = 0; i < node.children; i++) {
-		skip_nodes(fp,version);
-	}
-}
-
-
 void obj_reader_t::resolve_xrefs()
 {
 	slist_tpl<obj_desc_t *> xref_nodes;
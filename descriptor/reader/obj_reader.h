@@ -8,6 +8,7 @@
 
 
 #include <stdio.h>
+#include <string.h>
 
 #include "../obj_node_info.h"
 #include "../objversion.h"
@@ -80,8 +81,22 @@ class obj_reader_t
 	static unresolved_map unresolved;
 	static ptrhashtable_tpl<obj_desc_t **, int, N_BAGS_SMALL>  fatals;
 
-	static void read_nodes(FILE* fp, obj_desc_t*& data, int register_nodes,uint32 version);
-	static void skip_nodes(FILE *fp,uint32 version);
+	/// pak files are read and decoded into these in memory before registering
+	struct pak_node_t;
+	struct pak_file_t;
+	struct parse_job_t;
+
+	/// Reads @p pak into memory (unless already there) and splits it into nodes. Thread safe.
+	/// @returns false if the file could not be read or is too new
+	static bool parse_pak(pak_file_t &pak);
+	static bool parse_nodes(char *&p, const char *end, uint32 version, pak_node_t &node);
+	static void decode_nodes(pak_node_t &node);
+
+	/// Parses every step-th pak of a batch, called from several threads
+	static void *parse_paks_thread(void *job);
+	static void parse_paks(pak_file_t *paks, uint32 count);
+
+	static void read_nodes(pak_node_t &node, obj_desc_t*& data, int register_nodes);
 
 protected:
 	obj_reader_t() { /* Beware: Cannot register here! */}
@@ -91,9 +106,16 @@ protected:
 	static void xref_to_resolve(obj_type type, const char *name, obj_desc_t **dest, bool fatal);
 	static void resolve_xrefs();
 
-	/// Read a descriptor from @p fp. Does version check and compatibility transformations.
+	/// Read a descriptor from the node.size bytes at @p data. Does version check and compatibility transformations.
 	/// @returns The descriptor on success, or NULL on failure
-	virtual obj_desc_t *read_node(FILE *fp, obj_node_info_t &node) = 0;
+	virtual obj_desc_t *read_node(const char *data, obj_node_info_t &node) = 0;
+
+	/// Thread safe part of read_node(), called while several pak files are loaded in parallel.
+	/// @returns The decoded descriptor, or NULL to use read_node() instead
+	virtual obj_desc_t *decode_node(const char * /*data*/, obj_node_info_t &/*node*/) const { return NULL; }
+
+	/// Completes a descriptor from decode_node(); called in load order instead of read_node().
+	virtual obj_desc_t *read_decoded_node(obj_desc_t *desc) { return desc; }
 
 	/// Register descriptor so the object described by the descriptor can be built in-game.
 	virtual void register_obj(obj_desc_t *&/*desc*/) {}
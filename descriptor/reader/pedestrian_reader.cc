@@ -35,14 +35,14 @@ bool pedestrian_reader_t::successfully_loaded() const
  * Read a pedestrian info node. Does version check and
  * compatibility transformations.
  */
-obj_desc_t * pedestrian_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t * pedestrian_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	ALLOCA(char, desc_buf, node.size);
 
 	pedestrian_desc_t *desc = new pedestrian_desc_t();
 
 	// Read data
-	fread(desc_buf, node.size, 1, fp);
+	memcpy(desc_buf, data, node.size);
 	char * p = desc_buf;
 
 	// old versions of PAK files have no version stamp.
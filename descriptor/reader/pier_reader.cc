@@ -29,12 +29,12 @@ void pier_reader_t::shufflemask(uint64 &mask){
     mask|= (tmp & 0x00FF000000000000) >> 8;
 }
 
-obj_desc_t * pier_reader_t::read_node(FILE *fp, obj_node_info_t &node){
+obj_desc_t * pier_reader_t::read_node(const char *data, obj_node_info_t &node){
     ALLOCA(char, desc_buf, node.size);
 
     pier_desc_t *desc = new pier_desc_t();
 
-    fread(desc_buf, node.size, 1, fp);
+    memcpy(desc_buf, data, node.size);
 
     char * p = desc_buf;
 
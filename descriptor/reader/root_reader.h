@@ -17,7 +17,7 @@ public:
 	static root_reader_t*instance() { return &the_instance; }
 
 	/// @copydoc obj_reader_t::read_node
-	obj_desc_t *read_node(FILE *fp, obj_node_info_t &node) OVERRIDE;
+	obj_desc_t *read_node(const char *data, obj_node_info_t &node) OVERRIDE;
 
 	obj_type get_type() const OVERRIDE { return obj_root; }
 	char const* get_type_name() const OVERRIDE { return "root"; }
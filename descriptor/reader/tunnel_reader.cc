@@ -55,7 +55,7 @@ void tunnel_reader_t::convert_old_tunnel(tunnel_desc_t *desc)
 }
 
 
-obj_desc_t * tunnel_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t * tunnel_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	tunnel_desc_t *desc = new tunnel_desc_t();
 	desc->topspeed = 0; // indicate, that we have to convert this to reasonable date, when read completely
@@ -64,7 +64,7 @@ obj_desc_t * tunnel_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 		// newer versioned node
 		ALLOCA(char, desc_buf, node.size);
 
-		fread(desc_buf, node.size, 1, fp);
+		memcpy(desc_buf, data, node.size);
 
 		char * p = desc_buf;
 
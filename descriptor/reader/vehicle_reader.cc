@@ -35,14 +35,14 @@ bool vehicle_reader_t::successfully_loaded() const
 }
 
 
-obj_desc_t *vehicle_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t *vehicle_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	ALLOCA(char, desc_buf, node.size);
 
 	vehicle_desc_t *desc = new vehicle_desc_t();
 
 	// Read data
-	fread(desc_buf, node.size, 1, fp);
+	memcpy(desc_buf, data, node.size);
 	char * p = desc_buf;
 
 	// old versions of PAK files have no version stamp.
@@ -32,7 +32,7 @@ bool way_obj_reader_t::successfully_loaded() const
 }
 
 
-obj_desc_t * way_obj_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t * way_obj_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	ALLOCA(char, desc_buf, node.size);
 
@@ -40,7 +40,7 @@ obj_desc_t * way_obj_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 	// DBG_DEBUG("way_reader_t::read_node()", "node size = %d", node.size);
 
 	// Read data
-	fread(desc_buf, node.size, 1, fp);
+	memcpy(desc_buf, data, node.size);
 	char * p = desc_buf;
 
 	// old versions of PAK files have no version stamp.
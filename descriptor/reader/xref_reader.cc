@@ -11,12 +11,13 @@
 #include "../obj_node_info.h"
 
 
-obj_desc_t *xref_reader_t::read_node(FILE *fp, obj_node_info_t &node)
+obj_desc_t *xref_reader_t::read_node(const char *data, obj_node_info_t &node)
 {
 	char buf[4 + 1];
-	if (fread(buf, 1, 5, fp) != 5) {
+	if (node.size < 5) {
 		return NULL;
 	}
+	memcpy(buf, data, 5);
 
 	const uint32 name_len = node.size - 4 - 1;
 	char *p = buf;
@@ -25,10 +26,7 @@ obj_desc_t *xref_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 	desc->type = static_cast<obj_type>(decode_uint32(p));
 	desc->fatal = (decode_uint8(p) != 0);
 
-	if (fread(desc->name, 1, name_len, fp) != name_len) {
-		delete desc;
-		return NULL;
-	}
+	memcpy(desc->name, data + 5, name_len);
 
 //	DBG_DEBUG("xref_reader_t::read_node()", "%s",desc->get_text() );
 
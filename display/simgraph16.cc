@@ -48,7 +48,7 @@
 
 // currently just redrawing/rezooming
 static pthread_mutex_t rezoom_img_mutex[MAX_THREADS];
-static pthread_mutex_t recode_img_mutex;
+static pthread_mutex_t recode_img_mutex[MAX_THREADS];
 #endif
 
 // to pass the extra clipnum when not needed use this
@@ -250,11 +250,54 @@ clipping_info_t clips;
 
 static font_t default_font;
 
+// increased on every font change, to invalidate the text run caches
+static uint32 font_generation = 1;
+
 // needed for resizing gui
 int default_font_ascent = 0;
 int default_font_linespace = 0;
 
 
+/*
+ * Cache for rendered strings: all glyphs of a string are combined into one
+ * mask with one bit per pixel, so drawing a cached string needs neither
+ * utf8 decoding nor clipping glyph by glyph. Each cache is a set associative
+ * table, in a set the least recently used entry is replaced. Each drawing
+ * thread has its own cache.
+ */
+#define TEXT_RUN_CACHE_SETS (256)
+#define TEXT_RUN_CACHE_WAYS (4)
+#define TEXT_RUN_MAX_BYTES  (255)
+#define TEXT_RUN_MAX_WIDTH  (2048)
+
+struct text_run_t
+{
+	uint32 hash;
+	uint32 last_used; // 0: unused entry
+	uint16 len;       // length of text in bytes
+	uint16 width;     // advance of the whole string in pixels
+	uint16 pitch;     // bytes per row of the mask
+	uint16 height;    // rows of the mask
+	char *text;       // copy of the string (not zero terminated), followed by the mask
+	uint8 *bits;      // mask, msb is the leftmost pixel
+};
+
+struct text_run_cache_t
+{
+	text_run_t runs[TEXT_RUN_CACHE_SETS][TEXT_RUN_CACHE_WAYS];
+	uint32 clock;
+	uint32 font_generation;
+};
+
+#ifdef MULTI_THREAD
+static text_run_cache_t *text_run_caches[MAX_THREADS];
+#else
+static text_run_cache_t *text_run_caches;
+#endif
+
+#define TEXT_RUN_CACHE text_run_caches CLIP_NUM_INDEX
+
+
 #define RGBMAPSIZE (0x8000+LIGHT_COUNT+MAX_PLAYER_COUNT)
 
 
@@ -1189,15 +1232,19 @@ int zoom_factor_down()
 }
 
 
-static uint8 player_night=0xFF;
-static uint8 player_day=0xFF;
+static uint8 player_night=0;
+static uint8 player_day=0;
+// the colour maps do not hold the colours of player_day/player_night (yet)
+static bool player_day_dirty=true;
+static bool player_night_dirty=true;
 static void activate_player_color(sint8 player_nr, bool daynight)
 {
 	// caches the last settings
 	if(!daynight) {
-		if(player_day!=player_nr) {
+		if(player_day_dirty  ||  player_day!=player_nr) {
 			int i;
 			player_day = player_nr;
+			player_day_dirty = false;
 			for(i=0;  i<8;  i++  ) {
 				rgbmap_all_day[0x8000+i] = specialcolormap_all_day[player_offsets[player_day][0]+i];
 				rgbmap_all_day[0x8008+i] = specialcolormap_all_day[player_offsets[player_day][1]+i];
@@ -1228,9 +1275,10 @@ static void activate_player_color(sint8 player_nr, bool daynight)
 	}
 	else {
 		// changing color table
-		if(player_night!=player_nr) {
+		if(player_night_dirty  ||  player_night!=player_nr) {
 			int i;
 			player_night = player_nr;
+			player_night_dirty = false;
 			for(i=0;  i<8;  i++  ) {
 				rgbmap_day_night[0x8000+i] = specialcolormap_day_night[player_offsets[player_night][0]+i];
 				rgbmap_day_night[0x8008+i] = specialcolormap_day_night[player_offsets[player_night][1]+i];
@@ -1273,15 +1321,28 @@ static void recode()
 }
 
 
+/**
+ * Flag the images of one player to recode colors on next draw
+ */
+static void recode_player(const int player)
+{
+	for(  image_id n = 0;  n < anz_images;  n++  ) {
+		if(  images[n].recode_flags & FLAG_HAS_PLAYER_COLOR  ) {
+			images[n].player_flags |= 1<<player;
+		}
+	}
+}
+
+
 // to switch between 15 bit and 16 bit recoding ...
-typedef void (*display_recode_img_src_target_proc)(scr_coord_val h, PIXVAL *src, PIXVAL *target);
+typedef void (*display_recode_img_src_target_proc)(scr_coord_val h, PIXVAL *src, PIXVAL *target, const PIXVAL *player_colors);
 static display_recode_img_src_target_proc recode_img_src_target = NULL;
 
 
 /**
  * Convert a certain image data to actual output data
  */
-static void recode_img_src_target_15(scr_coord_val h, PIXVAL *src, PIXVAL *target)
+static void recode_img_src_target_15(scr_coord_val h, PIXVAL *src, PIXVAL *target, const PIXVAL *player_colors)
 {
 	if(  h > 0  ) {
 		do {
@@ -1295,7 +1356,7 @@ static void recode_img_src_target_15(scr_coord_val h, PIXVAL *src, PIXVAL *targe
 					while(  runlen--  ) {
 						if(  *src < 0x8020+(31*16)  ) {
 							// expand transparent player color
-							PIXVAL rgb555 = rgbmap_day_night[(*src-0x8020)/31+0x8000];
+							PIXVAL rgb555 = player_colors[(*src-0x8020)/31];
 							PIXVAL alpha = (*src-0x8020) % 31;
 							PIXVAL pix = ((rgb555 >> 6) & 0x0380) | ((rgb555 >>  4) & 0x0038) | ((rgb555 >> 2) & 0x07);
 							*target++ = 0x8020 + 31*31 + pix*31 + alpha;
@@ -1309,7 +1370,8 @@ static void recode_img_src_target_15(scr_coord_val h, PIXVAL *src, PIXVAL *targe
 				else {
 					// now just convert the color pixels
 					while(  runlen--  ) {
-						*target++ = rgbmap_day_night[*src++];
+						const PIXVAL col = *src++;
+						*target++ = (col & 0xFFF0) == 0x8000 ? player_colors[col & 0x000F] : rgbmap_day_night[col];
 					}
 				}
 				// next clear run or zero = end
@@ -1318,7 +1380,7 @@ static void recode_img_src_target_15(scr_coord_val h, PIXVAL *src, PIXVAL *targe
 	}
 }
 
-static void recode_img_src_target_16(scr_coord_val h, PIXVAL *src, PIXVAL *target)
+static void recode_img_src_target_16(scr_coord_val h, PIXVAL *src, PIXVAL *target, const PIXVAL *player_colors)
 {
 	if(  h > 0  ) {
 		do {
@@ -1332,7 +1394,7 @@ static void recode_img_src_target_16(scr_coord_val h, PIXVAL *src, PIXVAL *targe
 					while(  runlen--  ) {
 						if(  *src < 0x8020+(31*16)  ) {
 							// expand transparent player color
-							PIXVAL rgb565 = rgbmap_day_night[(*src-0x8020)/31+0x8000];
+							PIXVAL rgb565 = player_colors[(*src-0x8020)/31];
 							PIXVAL alpha = (*src-0x8020) % 31;
 							PIXVAL pix = ((rgb565 >> 6) & 0x0380) | ((rgb565 >>  3) & 0x0078) | ((rgb565 >> 2) & 0x07);
 							*target++ = 0x8020 + 31*31 + pix*31 + alpha;
@@ -1346,7 +1408,8 @@ static void recode_img_src_target_16(scr_coord_val h, PIXVAL *src, PIXVAL *targe
 				else {
 					// now just convert the color pixels
 					while(  runlen--  ) {
-						*target++ = rgbmap_day_night[*src++];
+						const PIXVAL col = *src++;
+						*target++ = (col & 0xFFF0) == 0x8000 ? player_colors[col & 0x000F] : rgbmap_day_night[col];
 					}
 				}
 				// next clear run or zero = end
@@ -1364,15 +1427,17 @@ image_id get_image_count()
 
 /**
  * Handles the conversion of an image to the output color
+ * The player colours come from a local table instead of the shared colour map,
+ * so different images can be recoded by the drawing threads at the same time.
  */
 static void recode_img(const image_id n, const sint8 player_nr)
 {
 	// may this image be zoomed
 #ifdef MULTI_THREAD
-	pthread_mutex_lock( &recode_img_mutex );
+	pthread_mutex_lock( &recode_img_mutex[n % env_t::num_threads] );
 	if(  (images[n].player_flags & (1<<player_nr)) == 0  ) {
 		// other thread did already the re-code...
-		pthread_mutex_unlock( &recode_img_mutex );
+		pthread_mutex_unlock( &recode_img_mutex[n % env_t::num_threads] );
 		return;
 	}
 #endif
@@ -1381,12 +1446,15 @@ static void recode_img(const image_id n, const sint8 player_nr)
 	if(  images[n].data[player_nr] == NULL  ) {
 		images[n].data[player_nr] = MALLOCN( PIXVAL, images[n].len );
 	}
-	// contains now the player color ...
-	activate_player_color( player_nr, true );
-	recode_img_src_target( images[n].h, src, images[n].data[player_nr] );
+	PIXVAL player_colors[16];
+	for(  int i = 0;  i < 8;  i++  ) {
+		player_colors[i] = specialcolormap_day_night[player_offsets[player_nr][0]+i];
+		player_colors[i+8] = specialcolormap_day_night[player_offsets[player_nr][1]+i];
+	}
+	recode_img_src_target( images[n].h, src, images[n].data[player_nr], player_colors );
 	images[n].player_flags &= ~(1<<player_nr);
 #ifdef MULTI_THREAD
-	pthread_mutex_unlock( &recode_img_mutex );
+	pthread_mutex_unlock( &recode_img_mutex[n % env_t::num_threads] );
 #endif
 }
 
@@ -2060,6 +2128,7 @@ static void calc_base_pal_from_night_shift(const int night)
 #endif
 	}
 	player_night = 0;
+	player_night_dirty = false;
 
 	// Lights
 	for (i = 0; i < LIGHT_COUNT; i++) {
@@ -2115,18 +2184,11 @@ void display_set_player_color_scheme(const int player, const uint8 col1, const u
 		player_offsets[player][0] = col1;
 		player_offsets[player][1] = col2;
 		if(player==player_day  ||  player==player_night) {
-			// and recalculate map (and save it)
-			calc_base_pal_from_night_shift(0);
-			memcpy(rgbmap_all_day, rgbmap_day_night, RGBMAPSIZE * sizeof(PIXVAL));
-			memcpy(transparent_map_all_day, transparent_map_day_night, lengthof(transparent_map_day_night) * sizeof(PIXVAL));
-			memcpy(transparent_map_all_day_rgb, transparent_map_day_night_rgb, lengthof(transparent_map_day_night_rgb) * sizeof(uint8));
-			if(night_shift!=0) {
-				calc_base_pal_from_night_shift(night_shift);
-			}
-			// calc_base_pal_from_night_shift resets player_night to 0
-			player_day = player_night;
+			// the colour maps hold the old colours, copy them again on next use
+			player_day_dirty = true;
+			player_night_dirty = true;
 		}
-		recode();
+		recode_player(player);
 		mark_screen_dirty();
 	}
 }
@@ -4505,6 +4567,7 @@ bool display_load_font(const char *fname, bool reload)
 
 	if(  loaded_fnt.load_from_file(fname)  ) {
 		default_font = loaded_fnt;
+		font_generation++;
 		default_font_ascent    = default_font.get_ascent();
 		default_font_linespace = default_font.get_linespace();
 
@@ -4748,6 +4811,167 @@ static unsigned char get_h_mask(const int xL, const int xR, const int cL, const
 }
 
 
+static void free_text_run_cache(text_run_cache_t *cache)
+{
+	for(  int set = 0;  set < TEXT_RUN_CACHE_SETS;  set++  ) {
+		for(  int way = 0;  way < TEXT_RUN_CACHE_WAYS;  way++  ) {
+			free( cache->runs[set][way].text );
+		}
+	}
+	memset( cache, 0, sizeof(text_run_cache_t) );
+}
+
+
+/**
+ * @returns the rendered string (up to len bytes, the end of the string or a linebreak)
+ * from the cache of this thread, or NULL if the string is too long to be cached
+ */
+static const text_run_t *get_text_run(const char *txt, sint32 len  CLIP_NUM_DEF)
+{
+	// find the length of the string and hash it (FNV-1a)
+	uint32 hash = 2166136261u;
+	sint32 n = 0;
+	while(  txt[n] != 0  &&  txt[n] != '\n'  ) {
+		// complete the last character even when len ends within
+		if(  n >= len  &&  (txt[n] & 0xC0) != 0x80  ) {
+			break;
+		}
+		if(  n >= TEXT_RUN_MAX_BYTES  ) {
+			return NULL;
+		}
+		hash = (hash ^ (uint8)txt[n]) * 16777619u;
+		n++;
+	}
+	if(  n == 0  ) {
+		return NULL;
+	}
+
+	text_run_cache_t *&cache = TEXT_RUN_CACHE;
+	if(  cache == NULL  ) {
+		cache = new text_run_cache_t();
+	}
+	if(  cache->font_generation != font_generation  ) {
+		free_text_run_cache( cache );
+		cache->font_generation = font_generation;
+	}
+	cache->clock++;
+
+	text_run_t *const set = cache->runs[hash % TEXT_RUN_CACHE_SETS];
+	text_run_t *victim = set;
+	for(  int way = 0;  way < TEXT_RUN_CACHE_WAYS;  way++  ) {
+		text_run_t &run = set[way];
+		if(  run.last_used  &&  run.hash == hash  &&  run.len == n  &&  memcmp( run.text, txt, n ) == 0  ) {
+			run.last_used = cache->clock;
+			return &run;
+		}
+		if(  run.last_used < victim->last_used  ) {
+			victim = &run;
+		}
+	}
+
+	// not known => measure ...
+	const font_t *const fnt = &default_font;
+	scr_coord_val width = 0;
+	scr_coord_val extent = 0;
+	utf8_decoder_t decoder((utf8 const*)txt);
+	while(  decoder.get_position() - (utf8 const*)txt < n  ) {
+		utf32 c = decoder.next();
+		if(  !fnt->is_valid_glyph(c)  ) {
+			c = 0;
+		}
+		// glyphs are drawn 16 pixels wide, even if narrower
+		extent = max( extent, width + 16 );
+		width += fnt->get_glyph_advance(c);
+	}
+	if(  extent > TEXT_RUN_MAX_WIDTH  ) {
+		return NULL;
+	}
+
+	// ... and render it
+	const uint16 pitch = (extent + 7) / 8 + 1;
+	const uint16 height = min( fnt->get_linespace(), (sint16)GLYPH_BITMAP_HEIGHT );
+	free( victim->text );
+	victim->text = (char *)MALLOCN( uint8, n + pitch * height );
+	victim->bits = (uint8 *)victim->text + n;
+	memcpy( victim->text, txt, n );
+	memset( victim->bits, 0, pitch * height );
+	victim->hash = hash;
+	victim->len = n;
+	victim->width = width;
+	victim->pitch = pitch;
+	victim->height = height;
+	victim->last_used = cache->clock;
+
+	scr_coord_val x = 0;
+	decoder = utf8_decoder_t((utf8 const*)txt);
+	while(  decoder.get_position() - (utf8 const*)txt < n  ) {
+		utf32 c = decoder.next();
+		if(  !fnt->is_valid_glyph(c)  ) {
+			c = 0;
+		}
+		const uint8 *const glyph = fnt->get_glyph_bitmap(c);
+		// currently max character width 16 bit supported by font.h/font.cc
+		for(  int i = 0;  i < 2;  i++  ) {
+			const int px = x + i*8;
+			const int shift = px & 7;
+			uint8 *dst = victim->bits + (px >> 3);
+			for(  int h = fnt->get_glyph_yoffset(c);  h < height;  h++  ) {
+				const uint8 dat = glyph[h + i*GLYPH_BITMAP_HEIGHT];
+				dst[h*pitch] |= dat >> shift;
+				if(  shift  ) {
+					dst[h*pitch + 1] |= dat << (8 - shift);
+				}
+			}
+		}
+		x += fnt->get_glyph_advance(c);
+	}
+	return victim;
+}
+
+
+/**
+ * Draws the rows [y_offset, y_end) of a rendered string,
+ * clipped horizontally to [cL, cR)
+ */
+static void display_text_run(const text_run_t *run, scr_coord_val x, scr_coord_val y, scr_coord_val y_offset, scr_coord_val y_end, scr_coord_val cL, scr_coord_val cR, const PIXVAL color)
+{
+	// visible columns of the mask
+	const scr_coord_val first = max( 0, cL - x );
+	const scr_coord_val last = min( (scr_coord_val)(run->pitch * 8), cR - x );
+	if(  first >= last  ) {
+		return;
+	}
+	const int first_byte = first >> 3;
+	const int last_byte = (last + 7) >> 3;
+	const uint8 first_mask = 0xFF >> (first & 7);
+	const uint8 last_mask = 0xFF << ((8 - (last & 7)) & 7);
+
+	const uint8 *row = run->bits + y_offset * run->pitch;
+	PIXVAL *line = textur + (y + y_offset) * disp_width + x;
+	for(  scr_coord_val h = y_offset;  h < y_end;  h++  ) {
+		for(  int b = first_byte;  b < last_byte;  b++  ) {
+			unsigned int dat = row[b];
+			if(  b == first_byte  ) {
+				dat &= first_mask;
+			}
+			if(  b == last_byte - 1  ) {
+				dat &= last_mask;
+			}
+			if(  dat != 0  ) {
+				PIXVAL *dst = line + b*8;
+				for(  size_t dat_offset = 0;  dat_offset < 8;  dat_offset++  ) {
+					if(  (dat & (0x80 >> dat_offset))  ) {
+						dst[dat_offset] = color;
+					}
+				}
+			}
+		}
+		row += run->pitch;
+		line += disp_width;
+	}
+}
+
+
 /**
  * len parameter added - use -1 for previous behaviour.
  * completely renovated for unicode and 10 bit width and variable height
@@ -4775,6 +4999,15 @@ int display_text_proportional_len_clip_rgb(scr_coord_val x, scr_coord_val y, con
 		len = 0x7FFF;
 	}
 
+	const font_t *const fnt = &default_font;
+
+	if (y >= cB || y + fnt->get_linespace() <= cT) {
+		// nothing to display
+		return 0;
+	}
+
+	const text_run_t *run = get_text_run(txt, len  CLIP_NUM_PAR);
+
 	// adapt x-coordinate for alignment
 	switch (flags & ( ALIGN_LEFT | ALIGN_CENTER_H | ALIGN_RIGHT) ) {
 		case ALIGN_LEFT:
@@ -4782,18 +5015,16 @@ int display_text_proportional_len_clip_rgb(scr_coord_val x, scr_coord_val y, con
 			break;
 
 		case ALIGN_CENTER_H:
-			x -= display_calc_proportional_string_len_width(txt, len) / 2;
+			x -= (run ? run->width : display_calc_proportional_string_len_width(txt, len)) / 2;
 			break;
 
 		case ALIGN_RIGHT:
-			x -= display_calc_proportional_string_len_width(txt, len);
+			x -= run ? run->width : display_calc_proportional_string_len_width(txt, len);
 			break;
 	}
 
 	// still something to display?
-	const font_t *const fnt = &default_font;
-
-	if (x >= cR || y >= cB || y + fnt->get_linespace() <= cT) {
+	if (x >= cR) {
 		// nothing to display
 		return 0;
 	}
@@ -4813,6 +5044,13 @@ int display_text_proportional_len_clip_rgb(scr_coord_val x, scr_coord_val y, con
 		glyph_height -= yy - cB;
 	}
 
+	if(  run  ) {
+		// already rendered: draw the whole string at once
+		display_text_run( run, x, y, y_offset, min( glyph_height, (scr_coord_val)run->height ), cL, cR, color );
+		x += run->width;
+		len = 0;
+	}
+
 	// big loop, draw char by char
 	utf8_decoder_t decoder((utf8 const*)txt);
 	size_t iTextPos = 0; // pointer on text position
@@ -5702,8 +5940,21 @@ void display_flush_buffer()
 #endif
 
 	// combine current with last dirty tiles
+	uint32 dirty_tiles = 0;
 	for(  int i = 0;  i < tile_buffer_length;  i++  ) {
 		tile_dirty_old[i] |= tile_dirty[i];
+		dirty_tiles += hammingWeight( tile_dirty_old[i] );
+	}
+
+	// scrolling or animated scenes touch nearly everything: one full frame update is cheaper than many rectangles
+	if(  dirty_tiles * 4 >= (uint32)(tiles_per_line * tile_lines) * 3  ) {
+		dr_textur( 0, 0, disp_actual_width, disp_height );
+		memset( tile_dirty_old, 0, sizeof(uint32) * tile_buffer_length );
+
+		uint32 *tmp = tile_dirty_old;
+		tile_dirty_old = tile_dirty;
+		tile_dirty = tmp;
+		return;
 	}
 
 	const int tile_words_per_line = tile_buffer_per_line >> 5;
@@ -5841,14 +6092,11 @@ bool simgraph_init(scr_size window_size, bool full_screen)
 	disp_actual_width = window_size.w;
 	disp_height = window_size.h;
 
-#ifdef MULTI_THREAD
-	pthread_mutex_init( &recode_img_mutex, NULL );
-#endif
-
-	// init rezoom_img()
+	// init rezoom_img() and recode_img()
 	for(  int i = 0;  i < MAX_THREADS;  i++  ) {
 #ifdef MULTI_THREAD
 		pthread_mutex_init( &rezoom_img_mutex[i], NULL );
+		pthread_mutex_init( &recode_img_mutex[i], NULL );
 #endif
 		rezoom_baseimage[i] = NULL;
 		rezoom_baseimage2[i] = NULL;
@@ -5892,6 +6140,7 @@ bool simgraph_init(scr_size window_size, bool full_screen)
 
 	// Calculate daylight rgbmap and save it for unshaded tile drawing
 	player_day = 0;
+	player_day_dirty = false;
 	display_day_night_shift(0);
 	memcpy(specialcolormap_all_day, specialcolormap_day_night, 256 * sizeof(PIXVAL));
 	memcpy(rgbmap_all_day, rgbmap_day_night, RGBMAPSIZE * sizeof(PIXVAL));
@@ -5969,10 +6218,26 @@ void simgraph_exit()
 
 	tile_dirty = tile_dirty_old = NULL;
 	images = NULL;
+
+#ifdef MULTI_THREAD
+	for(  int i = 0;  i < MAX_THREADS;  i++  ) {
+		if(  text_run_caches[i]  ) {
+			free_text_run_cache( text_run_caches[i] );
+			delete text_run_caches[i];
+			text_run_caches[i] = NULL;
+		}
+	}
+#else
+	if(  text_run_caches  ) {
+		free_text_run_cache( text_run_caches );
+		delete text_run_caches;
+		text_run_caches = NULL;
+	}
+#endif
 #ifdef MULTI_THREAD
-	pthread_mutex_destroy( &recode_img_mutex );
 	for(  int i = 0;  i < MAX_THREADS;  i++  ) {
 		pthread_mutex_destroy( &rezoom_img_mutex[i] );
+		pthread_mutex_destroy( &recode_img_mutex[i] );
 	}
 #endif
 }
@@ -330,3 +330,254 @@ void gui_scrolled_list_t::draw(scr_coord offset)
 
 	gui_scrollpane_t::draw(offset);
 }
+
+
+bool gui_scrolled_virtual_list_t::entry_compare_t::operator()(const entry_t &a, const entry_t &b) const
+{
+	int order = (a.key.value > b.key.value) - (a.key.value < b.key.value);
+	if(  order == 0  ) {
+		order = a.key.text.compare( b.key.text );
+	}
+	if(  order == 0  ) {
+		order = (a.key.value2 > b.key.value2) - (a.key.value2 < b.key.value2);
+	}
+	if(  order == 0  ) {
+		order = (a.id > b.id) - (a.id < b.id);
+	}
+	return reverse ? order > 0 : order < 0;
+}
+
+
+bool gui_scrolled_virtual_list_t::is_clean_entry(const entry_t &e)
+{
+	return !e.dirty;
+}
+
+
+gui_scrolled_virtual_list_t::gui_scrolled_virtual_list_t() :
+	gui_scrollpane_t(NULL, true)
+{
+	set_component(&container);
+	container.min_size = scr_size(0,0);
+	container.set_size( scr_size(0,0) );
+
+	row_height = 0;
+	row_width = 0;
+	reverse = false;
+	sorted = false;
+	rows_dirty = false;
+	maximize = false;
+}
+
+
+gui_scrolled_virtual_list_t::~gui_scrolled_virtual_list_t()
+{
+	delete_rows();
+}
+
+
+void gui_scrolled_virtual_list_t::delete_rows()
+{
+	FOR(vector_tpl<row_t>, const& r, rows) {
+		container.remove_component(r.comp);
+		delete r.comp;
+	}
+	rows.clear();
+}
+
+
+void gui_scrolled_virtual_list_t::measure_rows()
+{
+	row_height = 0;
+	row_width = 0;
+	for(  uint32 i=0;  i<entries.size();  i++  ) {
+		if(  is_valid_entry(entries[i].id)  ) {
+			gui_component_t *comp = create_row( entries[i].id );
+			const scr_size min_size = comp->get_min_size();
+			row_height = max( min_size.h, 1 );
+			row_width = min_size.w;
+			delete comp;
+			break;
+		}
+	}
+}
+
+
+void gui_scrolled_virtual_list_t::invalidate_rows()
+{
+	// the old rows may be in use by the event handling, so delete them on the next draw
+	rows_dirty = true;
+	measure_rows();
+	reset_container_size();
+}
+
+
+void gui_scrolled_virtual_list_t::reset_container_size()
+{
+	if(  row_height == 0  ) {
+		measure_rows();
+	}
+	container.min_size = scr_size( row_width + 2*D_H_SPACE, entries.size() * row_height );
+	container.set_size( scr_size( max(container.get_size().w, container.min_size.w), container.min_size.h ) );
+}
+
+
+void gui_scrolled_virtual_list_t::set_entries(const vector_tpl<uint32> &ids)
+{
+	vector_tpl<uint32> wanted(ids);
+	std::sort( wanted.begin(), wanted.end() );
+
+	// keep the known entries (which are still sorted) with their keys
+	vector_tpl<uint32> known( entries.size() );
+	uint32 n = 0;
+	for(  uint32 i=0;  i<entries.size();  i++  ) {
+		if(  std::binary_search( wanted.begin(), wanted.end(), entries[i].id )  ) {
+			if(  n != i  ) {
+				std::swap( entries[n], entries[i] );
+			}
+			known.append( entries[n].id );
+			n++;
+		}
+	}
+	entries.resize( n );
+	std::sort( known.begin(), known.end() );
+
+	// new entries are dirty and will be merged in by sort()
+	FOR(vector_tpl<uint32>, const id, ids) {
+		if(  !std::binary_search( known.begin(), known.end(), id )  ) {
+			entries.push_back( entry_t(id) );
+		}
+	}
+	reset_container_size();
+}
+
+
+void gui_scrolled_virtual_list_t::clear_entries()
+{
+	entries.clear();
+	sorted = false;
+	reset_container_size();
+}
+
+
+void gui_scrolled_virtual_list_t::set_reverse(bool r)
+{
+	if(  r != reverse  ) {
+		reverse = r;
+		sorted = false;
+	}
+}
+
+
+void gui_scrolled_virtual_list_t::sort()
+{
+	// refresh the keys and drop vanished entries
+	sort_key_t key;
+	uint32 n = 0, dirty = 0;
+	for(  uint32 i=0;  i<entries.size();  i++  ) {
+		entry_t &e = entries[i];
+		if(  !is_valid_entry(e.id)  ) {
+			continue;
+		}
+		get_sort_key( e.id, key );
+		if(  e.dirty  ||  key != e.key  ) {
+			std::swap( e.key, key );
+			e.dirty = true;
+			dirty++;
+		}
+		if(  n != i  ) {
+			std::swap( entries[n], e );
+		}
+		n++;
+	}
+	entries.resize( n );
+
+	const entry_compare_t cmp(reverse);
+	if(  !sorted  ||  dirty*8 > n  ) {
+		std::sort( entries.begin(), entries.end(), cmp );
+	}
+	else if(  dirty > 0  ) {
+		// the unchanged entries are still in order: sort the changed ones and merge
+		std::vector<entry_t>::iterator mid = std::stable_partition( entries.begin(), entries.end(), is_clean_entry );
+		std::sort( mid, entries.end(), cmp );
+		std::inplace_merge( entries.begin(), mid, entries.end(), cmp );
+	}
+	for(  uint32 i=0;  i<n;  i++  ) {
+		entries[i].dirty = false;
+	}
+	sorted = true;
+
+	reset_container_size();
+}
+
+
+void gui_scrolled_virtual_list_t::update_rows()
+{
+	if(  rows_dirty  ) {
+		delete_rows();
+		rows_dirty = false;
+	}
+	if(  entries.empty()  ||  row_height == 0  ) {
+		delete_rows();
+		return;
+	}
+
+	// range of visible rows
+	const sint32 top = get_scroll_y();
+	const uint32 first = min( (uint32)max(top, 0) / row_height, (uint32)entries.size() );
+	const uint32 last = min( (uint32)(max(top, 0) + get_client().h) / row_height + 1, (uint32)entries.size() );
+
+	scr_coord_val old_width = row_width, old_height = row_height;
+	vector_tpl<row_t> visible( last-first );
+	for(  uint32 i=first;  i<last;  i++  ) {
+		const uint32 id = entries[i].id;
+		if(  !is_valid_entry(id)  ) {
+			continue;
+		}
+		gui_component_t *comp = NULL;
+		FOR(vector_tpl<row_t>, &r, rows) {
+			if(  r.comp  &&  r.id == id  ) {
+				comp = r.comp;
+				r.comp = NULL;
+				break;
+			}
+		}
+		if(  comp == NULL  ) {
+			comp = create_row( id );
+			container.add_component( comp );
+			const scr_size min_size = comp->get_min_size();
+			row_width = max( row_width, min_size.w );
+			row_height = max( row_height, min_size.h );
+		}
+		comp->set_pos( scr_coord( D_H_SPACE, i*old_height ) );
+		visible.append( row_t(id, comp) );
+	}
+
+	// delete the rows scrolled out of view
+	FOR(vector_tpl<row_t>, const& r, rows) {
+		if(  r.comp  ) {
+			container.remove_component( r.comp );
+			delete r.comp;
+		}
+	}
+	rows = visible;
+
+	if(  old_width != row_width  ||  old_height != row_height  ) {
+		// a larger row appeared, positions will be corrected in the next frame
+		reset_container_size();
+	}
+
+	const scr_size row_size( max( container.get_size().w - 2*D_H_SPACE, row_width ), old_height );
+	FOR(vector_tpl<row_t>, const& r, rows) {
+		if(  r.comp->get_size() != row_size  ) {
+			r.comp->set_size( row_size );
+		}
+	}
+}
+
+
+void gui_scrolled_virtual_list_t::draw(scr_coord offset)
+{
+	update_rows();
+	gui_scrollpane_t::draw(offset);
+}
@@ -15,6 +15,9 @@
 #include "../../simcolor.h"
 #include "../../tpl/vector_tpl.h"
 
+#include <string>
+#include <vector>
+
 /**
  * Helper class to access the list of components in the scrolling container.
  */
@@ -185,4 +188,132 @@ public:
 	void set_maximize(bool b) { maximize = b; }
 };
 
+/**
+ * Scrollable list for very long lists with rows of equal height.
+ * Only the ids and the cached sort keys of the entries are stored,
+ * the row components are created on demand for the visible rows.
+ * Derived classes supply the rows and sort keys for the ids.
+ */
+class gui_scrolled_virtual_list_t : public gui_scrollpane_t
+{
+public:
+	/**
+	 * Sort key of an entry: ordered by value, then text, then value2.
+	 * Remaining ties are broken by the entry id.
+	 */
+	class sort_key_t
+	{
+	public:
+		sint64 value;
+		std::string text;
+		sint64 value2;
+
+		sort_key_t() : value(0), value2(0) {}
+
+		bool operator==(const sort_key_t &k) const { return value==k.value  &&  value2==k.value2  &&  text==k.text; }
+		bool operator!=(const sort_key_t &k) const { return !(*this==k); }
+	};
+
+private:
+	class entry_t
+	{
+	public:
+		uint32 id;
+		bool dirty; // key changed since last sort
+		sort_key_t key;
+
+		entry_t(uint32 i=0) : id(i), dirty(true) {}
+	};
+
+	class entry_compare_t
+	{
+	public:
+		bool reverse;
+		entry_compare_t(bool r) : reverse(r) {}
+		bool operator()(const entry_t &a, const entry_t &b) const;
+	};
+
+	static bool is_clean_entry(const entry_t &e);
+
+	class row_t
+	{
+	public:
+		uint32 id;
+		gui_component_t *comp;
+
+		row_t(uint32 i=0, gui_component_t *c=NULL) : id(i), comp(c) {}
+	};
+
+	/// holds only the currently materialised rows
+	class row_container_t : public gui_container_t
+	{
+	public:
+		scr_size min_size;
+
+		scr_size get_min_size() const OVERRIDE { return min_size; }
+		scr_size get_max_size() const OVERRIDE { return scr_size(scr_size::inf.w, min_size.h); }
+	};
+
+	row_container_t container;
+
+	std::vector<entry_t> entries;
+	vector_tpl<row_t> rows;
+
+	scr_coord_val row_height, row_width;
+
+	bool reverse:1;
+	bool sorted:1;
+	bool rows_dirty:1;
+	bool maximize:1;
+
+	/// determines the row size from a temporary row
+	void measure_rows();
+
+	void delete_rows();
+
+	/// creates the rows in the viewport and deletes the ones scrolled away
+	void update_rows();
+
+	void reset_container_size();
+
+protected:
+	virtual gui_component_t *create_row(uint32 id) = 0;
+
+	virtual void get_sort_key(uint32 id, sort_key_t &key) const = 0;
+
+	/// vanished entries are dropped during sort()
+	virtual bool is_valid_entry(uint32) const { return true; }
+
+public:
+	gui_scrolled_virtual_list_t();
+
+	~gui_scrolled_virtual_list_t();
+
+	/**
+	 * Sets the ids of the entries. Entries already in the list keep
+	 * their position and sort key, new ones are merged in by sort().
+	 */
+	void set_entries(const vector_tpl<uint32> &ids);
+
+	void clear_entries();
+
+	uint32 get_count() const { return entries.size(); }
+
+	void set_reverse(bool r);
+
+	/**
+	 * Refreshes the sort keys and sorts the list. If only few keys changed,
+	 * the changed entries are sorted separately and merged in.
+	 */
+	void sort();
+
+	/// rows will be recreated, e.g. after their display mode changed
+	void invalidate_rows();
+
+	void draw(scr_coord pos) OVERRIDE;
+
+	bool is_marginless() const OVERRIDE { return maximize; }
+	void set_maximize(bool b) { maximize = b; }
+};
+
 #endif
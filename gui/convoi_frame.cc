@@ -51,43 +51,35 @@ const slist_tpl<const goods_desc_t*>* convoi_frame_t::waren_filter = NULL;
 const uint8 convoi_frame_t::sortmode_to_label[SORT_MODES] = { 0,1,9,2,0,0,4,5,6,7,8 };
 /**
  * Scrolled list of gui_convoiinfo_ts.
- * Filters (by setting visibility) and sorts.
+ * Only the visible rows are created.
  */
-class gui_scrolled_convoy_list_t : public gui_scrolled_list_t
+class gui_scrolled_convoy_list_t : public gui_scrolled_virtual_list_t
 {
-	convoi_frame_t *main;
-
-	static convoi_frame_t *main_static;
-public:
-	gui_scrolled_convoy_list_t(convoi_frame_t *m) :  gui_scrolled_list_t(gui_scrolled_list_t::windowskin)
+protected:
+	gui_component_t *create_row(uint32 id) OVERRIDE
 	{
-		main = m;
-		set_cmp(compare);
+		convoihandle_t cnv;
+		cnv.set_id(id);
+		gui_convoiinfo_t *info = new gui_convoiinfo_t(cnv);
+		info->set_mode(cl_display_mode);
+		info->set_switchable_label(convoi_frame_t::sortmode_to_label[default_sortmode]);
+		return info;
 	}
 
-	void sort()
+	void get_sort_key(uint32 id, sort_key_t &key) const OVERRIDE
 	{
-		// set visibility according to filter
-		for(  vector_tpl<gui_component_t*>::iterator iter = item_list.begin();  iter != item_list.end();  ++iter) {
-			gui_convoiinfo_t *a = dynamic_cast<gui_convoiinfo_t*>(*iter);
-
-			a->set_visible( main->passes_filter(a->get_cnv()) );
-			a->set_mode(cl_display_mode);
-			a->set_switchable_label(convoi_frame_t::sortmode_to_label[default_sortmode]);
-		}
-		main_static = main;
-		gui_scrolled_list_t::sort(0);
+		convoihandle_t cnv;
+		cnv.set_id(id);
+		convoi_frame_t::get_sort_key(cnv, key);
 	}
 
-	static bool compare(const gui_component_t *aa, const gui_component_t *bb)
+	bool is_valid_entry(uint32 id) const OVERRIDE
 	{
-		const gui_convoiinfo_t *a = dynamic_cast<const gui_convoiinfo_t*>(aa);
-		const gui_convoiinfo_t *b = dynamic_cast<const gui_convoiinfo_t*>(bb);
-
-		return main_static->compare_convois(a->get_cnv(), b->get_cnv());
+		convoihandle_t cnv;
+		cnv.set_id(id);
+		return cnv.is_bound();
 	}
 };
-convoi_frame_t* gui_scrolled_convoy_list_t::main_static;
 
 
 bool convoi_frame_t::passes_filter(convoihandle_t cnv)
@@ -135,84 +127,61 @@ bool convoi_frame_t::passes_filter(convoihandle_t cnv)
 }
 
 
-bool convoi_frame_t::compare_convois(convoihandle_t const cnv1, convoihandle_t const cnv2)
+void convoi_frame_t::get_sort_key(convoihandle_t const cnv, gui_scrolled_virtual_list_t::sort_key_t &key)
 {
-	sint32 result = 0;
+	key.value = 0;
+	key.value2 = 0;
+	key.text.clear();
 
 	switch (sortby) {
 		default:
 		case by_name:
-			result = strcmp(cnv1->get_internal_name(), cnv2->get_internal_name());
+			key.text = cnv->get_internal_name();
 			break;
 		case by_line:
-			result = cnv1->get_line().get_id() - cnv2->get_line().get_id();
+			key.value = cnv->get_line().get_id();
 			break;
 		case by_home_depot:
 		{
-			char a_name[256] = "\0";
-			char b_name[256] = "\0";
-			const koord3d a_coord = cnv1->get_home_depot();
-			const koord3d b_coord = cnv2->get_home_depot();
-			if( a_coord !=koord3d::invalid ) {
-				if( grund_t* gr = welt->lookup(a_coord) ) {
-					if( depot_t* dep = gr->get_depot() ) {
-						tstrncpy(a_name, dep->get_name(), lengthof(a_name) );
-					}
-				}
-			}
-			if( b_coord !=koord3d::invalid ) {
-				if( grund_t* gr = welt->lookup(b_coord) ) {
+			const koord3d coord = cnv->get_home_depot();
+			if( coord !=koord3d::invalid ) {
+				if( grund_t* gr = welt->lookup(coord) ) {
 					if( depot_t* dep = gr->get_depot() ) {
-						tstrncpy(b_name, dep->get_name(), lengthof(b_name) );
+						key.text = dep->get_name();
 					}
 				}
-			}
-			result = strcmp(a_name, b_name);
-			if( result==0  &&  a_coord!=koord3d::invalid  &&  b_coord!=koord3d::invalid ) {
-				result = a_coord.x - b_coord.x;
-				if (result == 0) {
-					result = a_coord.y - b_coord.y;
-				}
+				key.value2 = ((sint64)coord.x << 32) + coord.y;
 			}
 			break;
 		}
 		case by_profit:
-			result = sgn(cnv1->get_jahresgewinn() - cnv2->get_jahresgewinn());
+			key.value = cnv->get_jahresgewinn();
 			break;
 		case by_type:
-			if(cnv1->get_vehicle_count()*cnv2->get_vehicle_count()>0) {
-				vehicle_t const* const tdriver1 = cnv1->front();
-				vehicle_t const* const tdriver2 = cnv2->front();
-
-				result = tdriver1->get_typ() - tdriver2->get_typ();
-				if(result == 0) {
-					result = tdriver1->get_cargo_type()->get_catg_index() - tdriver2->get_cargo_type()->get_catg_index();
-					if(result == 0) {
-						result = tdriver1->get_base_image() - tdriver2->get_base_image();
-					}
-				}
+			if(cnv->get_vehicle_count()>0) {
+				vehicle_t const* const tdriver = cnv->front();
+				key.value = ((sint64)tdriver->get_typ() << 48) + ((sint64)tdriver->get_cargo_type()->get_catg_index() << 32) + tdriver->get_base_image();
 			}
 			break;
 		case by_id:
-			result = cnv1.get_id()-cnv2.get_id();
+			key.value = cnv.get_id();
 			break;
 		case by_max_speed:
-			result = cnv1->get_min_top_speed() - cnv2->get_min_top_speed();
+			key.value = cnv->get_min_top_speed();
 			break;
 		case by_power:
-			result = cnv1->get_sum_power() - cnv2->get_sum_power();
+			key.value = cnv->get_sum_power();
 			break;
 		case by_value:
-			result = cnv1->get_purchase_cost() - cnv2->get_purchase_cost();
+			key.value = cnv->get_purchase_cost();
 			break;
 		case by_age:
-			result = cnv1->get_average_age() - cnv2->get_average_age();
+			key.value = cnv->get_average_age();
 			break;
 		case by_range:
-			result = cnv1->get_min_range() - cnv2->get_min_range();
+			key.value = cnv->get_min_range();
 			break;
 	}
-	return sortreverse ? result > 0 : result < 0;
 }
 
 
@@ -221,20 +190,22 @@ void convoi_frame_t::fill_list()
 	last_world_convois = welt->convoys().get_count();
 
 	const bool all = owner->get_player_nr() == 1;
-	scrolly->clear_elements();
+	vector_tpl<uint32> ids;
 	FOR(vector_tpl<convoihandle_t>, const cnv, welt->convoys()) {
 		if(  all  ||  cnv->get_owner()==owner  ) {
 			if(  passes_filter( cnv )  ) {
-				scrolly->new_component<gui_convoiinfo_t>( cnv );
+				ids.append( cnv.get_id() );
 			}
 		}
 	}
+	scrolly->set_entries( ids );
 	sort_list();
 }
 
 
 void convoi_frame_t::sort_list()
 {
+	scrolly->set_reverse( sortreverse );
 	scrolly->sort();
 }
 
@@ -312,7 +283,7 @@ convoi_frame_t::convoi_frame_t() :
 	}
 	end_table();
 
-	scrolly = new gui_scrolled_convoy_list_t(this);
+	scrolly = new gui_scrolled_convoy_list_t();
 	scrolly->set_maximize( true );
 
 	tabs.init_tabs(scrolly);
@@ -361,6 +332,8 @@ bool convoi_frame_t::action_triggered( gui_action_creator_t *comp, value_t /* */
 			sortby = convoi_frame_t::by_name;
 		}
 		default_sortmode = (uint8)tmp;
+		// the rows show a value depending on the sort mode
+		scrolly->invalidate_rows();
 		sort_list();
 	}
 	else if(  comp==&sort_order  ) {
@@ -370,6 +343,7 @@ bool convoi_frame_t::action_triggered( gui_action_creator_t *comp, value_t /* */
 	}
 	else if(  comp==&overview_selector  ) {
 		cl_display_mode = overview_selector.get_selection();
+		scrolly->invalidate_rows();
 		sort_list();
 		resize(scr_size(0, 0));
 	}
@@ -451,6 +425,7 @@ void convoi_frame_t::rdwr(loadsave_t *file)
 		owner = welt->get_player(player_nr);
 		win_set_magic(this, magic_convoi_list + player_nr);
 
+		scrolly->invalidate_rows();
 		fill_list();
 		set_windowsize(size);
 
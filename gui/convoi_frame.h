@@ -15,6 +15,7 @@
 #include "components/gui_combobox.h"
 #include "components/gui_waytype_tab_panel.h"
 #include "components/gui_textinput.h"
+#include "components/gui_scrolled_list.h"
 #include "../convoihandle_t.h"
 
 class player_t;
@@ -89,7 +90,8 @@ private:
 
 public:
 
-	static bool compare_convois(convoihandle_t, convoihandle_t);
+	/// sort key of a convoi for the current sort mode
+	static void get_sort_key(convoihandle_t, gui_scrolled_virtual_list_t::sort_key_t &key);
 
 	/**
 	 * Check all filters for one convoi.
@@ -30,42 +30,57 @@ uint8 halt_list_frame_t::display_mode = 0;
 
 /**
  * Scrolled list of halt_list_stats_ts.
- * Filters (by setting visibility) and sorts.
+ * Only the visible rows are created.
  */
-class gui_scrolled_halt_list_t : public gui_scrolled_list_t
+class gui_scrolled_halt_list_t : public gui_scrolled_virtual_list_t
 {
 	uint8 mode = halt_list_frame_t::display_mode;
-public:
-	gui_scrolled_halt_list_t() :  gui_scrolled_list_t(gui_scrolled_list_t::windowskin, compare) {}
+	uint8 player_nr = (uint8)-1;
 
-	void sort()
+protected:
+	gui_component_t *create_row(uint32 id) OVERRIDE
 	{
-		// set visibility according to filter
-		for(  vector_tpl<gui_component_t*>::iterator iter = item_list.begin();  iter != item_list.end();  ++iter) {
-			halt_list_stats_t *a = dynamic_cast<halt_list_stats_t*>(*iter);
+		halthandle_t halt;
+		halt.set_id(id);
+		halt_list_stats_t *stats = new halt_list_stats_t(halt, player_nr);
+		stats->set_mode(mode);
+		return stats;
+	}
 
-			a->set_visible( passes_filter(*a->get_halt()) );
-			a->set_mode(mode);
-		}
+	void get_sort_key(uint32 id, sort_key_t &key) const OVERRIDE
+	{
+		halthandle_t halt;
+		halt.set_id(id);
+		halt_list_frame_t::get_sort_key(halt, key);
+	}
 
-		gui_scrolled_list_t::sort(0);
+	bool is_valid_entry(uint32 id) const OVERRIDE
+	{
+		halthandle_t halt;
+		halt.set_id(id);
+		return halt.is_bound();
 	}
 
+public:
 	void set_mode(uint8 m)
 	{
-		mode = m;
+		if(  m != mode  ) {
+			mode = m;
+			invalidate_rows();
+		}
 	}
 
-	static bool compare(const gui_component_t *aa, const gui_component_t *bb)
+	void set_player_nr(uint8 nr)
 	{
-		const halt_list_stats_t *a = dynamic_cast<const halt_list_stats_t*>(aa);
-		const halt_list_stats_t *b = dynamic_cast<const halt_list_stats_t*>(bb);
-
-		return halt_list_frame_t::compare_halts(a->get_halt(), b->get_halt());
+		if(  nr != player_nr  ) {
+			player_nr = nr;
+			invalidate_rows();
+		}
 	}
 };
 
 
+
 /**
  * All filter and sort settings are static, so the old settings are
  * used when the window is reopened.
@@ -139,168 +154,95 @@ const char *halt_list_frame_t::display_mode_text[halt_list_stats_t::HALTLIST_MOD
 
 
 /**
-* This function compares two stations
-*
-* @return halt1 < halt2
+* Sort key of a station for the current sort mode.
+* The name is used as an additional key, to make sort more stable.
 */
-bool halt_list_frame_t::compare_halts(halthandle_t const halt1, halthandle_t const halt2)
+void halt_list_frame_t::get_sort_key(halthandle_t const halt, gui_scrolled_virtual_list_t::sort_key_t &key)
 {
-	int order;
+	sint64 order;
 
-	/***********************************
-	* Compare station 1 and station 2
-	***********************************/
 	switch (sortby) {
 		default:
 		case nach_name: // sort by station name
 			order = 0;
 			break;
 		case by_waiting_pax:
-		{
 			// Distinguish between 0 and "disable"
-			const int a = halt1->get_pax_enabled() ? halt1->get_ware_summe(goods_manager_t::get_info(goods_manager_t::INDEX_PAS)) : -1;
-			const int b = halt2->get_pax_enabled() ? halt2->get_ware_summe(goods_manager_t::get_info(goods_manager_t::INDEX_PAS)) : -1;
-			order = (int)(a - b);
+			order = halt->get_pax_enabled() ? halt->get_ware_summe(goods_manager_t::get_info(goods_manager_t::INDEX_PAS)) : -1;
 			break;
-		}
 		case by_waiting_mail:
-		{
 			// Distinguish between 0 and "disable"
-			const int a = halt1->get_mail_enabled() ? halt1->get_ware_summe(goods_manager_t::get_info(goods_manager_t::INDEX_MAIL)) : -1;
-			const int b = halt2->get_mail_enabled() ? halt2->get_ware_summe(goods_manager_t::get_info(goods_manager_t::INDEX_MAIL)) : -1;
-			order = (int)(a - b);
+			order = halt->get_mail_enabled() ? halt->get_ware_summe(goods_manager_t::get_info(goods_manager_t::INDEX_MAIL)) : -1;
 			break;
-		}
 		case by_waiting_goods:
-		{
-			const int waiting_goods_a = halt1->get_ware_enabled() ? (int)(halt1->get_finance_history(0, HALT_WAITING) - halt1->get_ware_summe(goods_manager_t::get_info(goods_manager_t::INDEX_PAS)) - halt1->get_ware_summe(goods_manager_t::get_info(goods_manager_t::INDEX_MAIL))): -1;
-			const int waiting_goods_b = halt2->get_ware_enabled() ? (int)(halt2->get_finance_history(0, HALT_WAITING) - halt2->get_ware_summe(goods_manager_t::get_info(goods_manager_t::INDEX_PAS)) - halt2->get_ware_summe(goods_manager_t::get_info(goods_manager_t::INDEX_MAIL))): -1;
-			order = waiting_goods_a - waiting_goods_b;
+			order = halt->get_ware_enabled() ? (int)(halt->get_finance_history(0, HALT_WAITING) - halt->get_ware_summe(goods_manager_t::get_info(goods_manager_t::INDEX_PAS)) - halt->get_ware_summe(goods_manager_t::get_info(goods_manager_t::INDEX_MAIL))): -1;
 			break;
-		}
 		case nach_typ: // sort by station type
-			order = halt1->get_station_type() - halt2->get_station_type();
+			order = halt->get_station_type();
 			break;
 		case by_tiles:
-			order = halt1->get_tiles().get_count() - halt2->get_tiles().get_count();
-			if (order == 0) {
-				order = halt1->calc_maintenance()-halt2->calc_maintenance();
-			}
+			// maintenance as secondary key
+			order = ((sint64)halt->get_tiles().get_count() << 40) + clamp<sint64>(halt->calc_maintenance(), 0, ((sint64)1 << 40) - 1);
 			break;
 		case by_capacity:
-		{
-			const uint64 a = halt1->get_capacity(0) + halt1->get_capacity(1) + halt1->get_capacity(2);
-			const uint64 b = halt2->get_capacity(0) + halt2->get_capacity(1) + halt2->get_capacity(2);
-			order = (int)(a - b);
+			order = halt->get_capacity(0) + halt->get_capacity(1) + halt->get_capacity(2);
 			break;
-		}
 		case by_overcrowding_rate:
 		{
-			uint8 weighting_a = halt1->get_pax_enabled() + halt1->get_mail_enabled() + halt1->get_ware_enabled();
-			uint8 weighting_b = halt2->get_pax_enabled() + halt2->get_mail_enabled() + halt2->get_ware_enabled();
-			if (!weighting_a) { weighting_a=1; }
-			if (!weighting_b) { weighting_b=1; }
-			const sint64 crowding_factor_a = halt1->get_overcrowded_proporion(0) + halt1->get_overcrowded_proporion(1) + halt1->get_overcrowded_proporion(2);
-			const sint64 crowding_factor_b = halt2->get_overcrowded_proporion(0) + halt2->get_overcrowded_proporion(1) + halt2->get_overcrowded_proporion(2);
-			order = crowding_factor_a/weighting_a - crowding_factor_b/weighting_b;
+			uint8 weighting = halt->get_pax_enabled() + halt->get_mail_enabled() + halt->get_ware_enabled();
+			if (!weighting) { weighting=1; }
+			const sint64 crowding_factor = halt->get_overcrowded_proporion(0) + halt->get_overcrowded_proporion(1) + halt->get_overcrowded_proporion(2);
+			order = crowding_factor/weighting;
 			break;
 		}
 		case by_potential_pax:
-			order = halt1->get_potential_passenger_number(1) - halt2->get_potential_passenger_number(1);
+			order = halt->get_potential_passenger_number(1);
 			break;
 		case by_potential_mail:
-			order = (int)(halt1->get_finance_history(1, HALT_MAIL_DELIVERED) + halt1->get_finance_history(1, HALT_MAIL_NOROUTE) - halt2->get_finance_history(1, HALT_MAIL_DELIVERED) - halt2->get_finance_history(1, HALT_MAIL_NOROUTE));
+			order = halt->get_finance_history(1, HALT_MAIL_DELIVERED) + halt->get_finance_history(1, HALT_MAIL_NOROUTE);
 			break;
 		case by_pax_happy_last_month:
-		{
-			const int happy_a = halt1->get_pax_enabled() ? halt1->get_finance_history(1, HALT_HAPPY) : -1;
-			const int happy_b = halt2->get_pax_enabled() ? halt2->get_finance_history(1, HALT_HAPPY) : -1;
-			order = (int)(happy_a - happy_b);
+			order = halt->get_pax_enabled() ? halt->get_finance_history(1, HALT_HAPPY) : -1;
 			break;
-		}
 		case by_mail_delivered_last_month:
-		{
-			const int delivered_a = halt1->get_mail_enabled() ? halt1->get_finance_history(1, HALT_MAIL_DELIVERED) : -1;
-			const int delivered_b = halt2->get_mail_enabled() ? halt2->get_finance_history(1, HALT_MAIL_DELIVERED) : -1;
-			order = (int)(delivered_a - delivered_b);
+			order = halt->get_mail_enabled() ? halt->get_finance_history(1, HALT_MAIL_DELIVERED) : -1;
 			break;
-		}
 		case by_pax_handled_last_month:
-		{
-			const int hist_a = halt1->get_pax_enabled() ? halt1->get_finance_history(1, HALT_VISITORS)+halt2->get_finance_history(1, HALT_COMMUTERS) : -1;
-			const int hist_b = halt2->get_pax_enabled() ? halt2->get_finance_history(1, HALT_VISITORS)+halt2->get_finance_history(1, HALT_COMMUTERS) : -1;
-			order = (int)(hist_a - hist_b);
+			order = halt->get_pax_enabled() ? halt->get_finance_history(1, HALT_VISITORS)+halt->get_finance_history(1, HALT_COMMUTERS) : -1;
 			break;
-		}
 		case by_mail_handled_last_month:
-		{
-			const int hist_a = halt1->get_mail_enabled() ? halt1->get_finance_history(1, HALT_MAIL_HANDLING_VOLUME) : -1;
-			const int hist_b = halt2->get_mail_enabled() ? halt2->get_finance_history(1, HALT_MAIL_HANDLING_VOLUME) : -1;
-			order = (int)(hist_a - hist_b);
+			order = halt->get_mail_enabled() ? halt->get_finance_history(1, HALT_MAIL_HANDLING_VOLUME) : -1;
 			break;
-		}
 		case by_goods_handled_last_month:
-		{
-			const int hist_a = halt1->get_ware_enabled() ? halt1->get_finance_history(1, HALT_GOODS_HANDLING_VOLUME) : -1;
-			const int hist_b = halt2->get_ware_enabled() ? halt2->get_finance_history(1, HALT_GOODS_HANDLING_VOLUME) : -1;
-			order = (int)(hist_a - hist_b);
+			order = halt->get_ware_enabled() ? halt->get_finance_history(1, HALT_GOODS_HANDLING_VOLUME) : -1;
 			break;
-		}
 		case by_convoy_arrivals_last_month:
-			order = (int)(halt1->get_finance_history(1, HALT_CONVOIS_ARRIVED) - halt2->get_finance_history(1, HALT_CONVOIS_ARRIVED));
+			order = halt->get_finance_history(1, HALT_CONVOIS_ARRIVED);
 			break;
 		case by_region:
-			order = welt->get_region(halt1->get_basis_pos()) - welt->get_region(halt2->get_basis_pos());
-			if (order == 0) {
-				const koord a = world()->get_city(halt1->get_basis_pos()) ? world()->get_city(halt1->get_basis_pos())->get_pos() : koord(0,0);
-				const koord b = world()->get_city(halt2->get_basis_pos()) ? world()->get_city(halt2->get_basis_pos())->get_pos() : koord(0,0);
-				order = a.x - b.x;
-				if (order == 0) {
-					order = a.y - b.y;
-				}
-			}
-			break;
-
-		case by_surrounding_population:
 		{
-			const int a = halt1->get_pax_enabled() ? halt1->get_around_population() : -1;
-			const int b = halt2->get_pax_enabled() ? halt2->get_around_population() : -1;
-			order = (int)(a - b);
+			// position of the city as secondary key
+			const stadt_t *city = world()->get_city(halt->get_basis_pos());
+			const koord pos = city ? city->get_pos() : koord(0,0);
+			order = ((sint64)welt->get_region(halt->get_basis_pos()) << 40) + ((sint64)pos.x << 20) + pos.y;
 			break;
 		}
+		case by_surrounding_population:
+			order = halt->get_pax_enabled() ? halt->get_around_population() : -1;
+			break;
 		case by_surrounding_mail_demand:
-		{
-			const int a = halt1->get_mail_enabled() ? halt1->get_around_mail_demand() : -1;
-			const int b = halt2->get_mail_enabled() ? halt2->get_around_mail_demand() : -1;
-			order = (int)(a - b);
+			order = halt->get_mail_enabled() ? halt->get_around_mail_demand() : -1;
 			break;
-		}
 		case by_surrounding_visitor_demand:
-		{
-			const int a = halt1->get_pax_enabled() ? halt1->get_around_visitor_demand() : -1;
-			const int b = halt2->get_pax_enabled() ? halt2->get_around_visitor_demand() : -1;
-			order = (int)(a - b);
+			order = halt->get_pax_enabled() ? halt->get_around_visitor_demand() : -1;
 			break;
-		}
 		case by_surrounding_jobs:
-		{
-			const int a = halt1->get_pax_enabled() ? halt1->get_around_job_demand() : -1;
-			const int b = halt2->get_pax_enabled() ? halt2->get_around_job_demand() : -1;
-			order = (int)(a - b);
+			order = halt->get_pax_enabled() ? halt->get_around_job_demand() : -1;
 			break;
-		}
-
 	}
-	/**
-	 * use name as an additional sort, to make sort more stable.
-	 */
-	if(order == 0) {
-		order = strcmp(halt1->get_name(), halt2->get_name());
-	}
-	/***********************************
-	 * Consider sorting order
-	 ***********************************/
-	return sortreverse ? order > 0 : order < 0;
+	key.value = order;
+	key.text = halt->get_name();
+	key.value2 = 0;
 }
 
 
@@ -581,25 +523,29 @@ void halt_list_frame_t::fill_list()
 			}
 		}
 	}
+	sort_list();
+}
 
-	scrolly->clear_elements();
+
+void halt_list_frame_t::sort_list()
+{
+	vector_tpl<uint32> ids;
 	FOR(vector_tpl<halthandle_t>, const halt, haltestelle_t::get_alle_haltestellen()) {
 		if (filter_city != NULL){
 			if (filter_city != world()->get_city(halt->get_basis_pos())) {
 				continue;
 			}
-			scrolly->new_component<halt_list_stats_t>(halt, (uint8)-1);
 		}
-		else if(  halt->get_owner() == m_player || (show_mutual_stops && halt->has_available_network(m_player))  ) {
-			scrolly->new_component<halt_list_stats_t>(halt, show_mutual_stops ? m_player->get_player_nr() : (uint8)-1);
+		else if(  halt->get_owner() != m_player  &&  !(show_mutual_stops && halt->has_available_network(m_player))  ) {
+			continue;
+		}
+		if(  passes_filter(*halt)  ) {
+			ids.append( halt.get_id() );
 		}
 	}
-	sort_list();
-}
-
-
-void halt_list_frame_t::sort_list()
-{
+	scrolly->set_player_nr( filter_city==NULL  &&  show_mutual_stops ? m_player->get_player_nr() : (uint8)-1 );
+	scrolly->set_entries( ids );
+	scrolly->set_reverse( sortreverse );
 	scrolly->sort();
 }
 
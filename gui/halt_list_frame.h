@@ -13,6 +13,7 @@
 #include "halt_list_stats.h"
 #include "components/gui_button.h"
 #include "components/gui_combobox.h"
+#include "components/gui_scrolled_list.h"
 #include "components/action_listener.h"
 #include "../tpl/vector_tpl.h"
 
@@ -120,7 +121,8 @@ private:
 
 public:
 
-	static bool compare_halts(halthandle_t, halthandle_t);
+	/// sort key of a station for the current sort mode
+	static void get_sort_key(halthandle_t, gui_scrolled_virtual_list_t::sort_key_t &key);
 	static uint8 display_mode;
 
 	halt_list_frame_t(stadt_t *filter_city = NULL);
@@ -142,7 +144,7 @@ public:
 	 */
 	void draw(scr_coord pos, scr_size size) OVERRIDE;
 
-	/// sort & filter halts in list
+	/// filter & sort halts in list
 	void sort_list();
 
 	/**
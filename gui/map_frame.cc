@@ -557,13 +557,13 @@ bool map_frame_t::action_triggered( gui_action_creator_t *comp, value_t)
 		// terrain heights color scale
 		minimap_t::get_instance()->show_contour ^= 1;
 		b_show_contour.pressed = minimap_t::get_instance()->show_contour;
-		minimap_t::get_instance()->invalidate_map_lines_cache();
+		minimap_t::get_instance()->invalidate_map();
 	}
 	else if (comp == &b_show_buildings) {
 		// terrain heights color scale
 		minimap_t::get_instance()->show_buildings ^= 1;
 		b_show_buildings.pressed = minimap_t::get_instance()->show_buildings;
-		minimap_t::get_instance()->invalidate_map_lines_cache();
+		minimap_t::get_instance()->invalidate_map();
 	}
 	else if(comp==&b_overlay_networks) {
 		// This button deactivates station mode.
@@ -19,6 +19,7 @@
 #include "../dataobj/translator.h"
 #include "../dataobj/schedule.h"
 #include "../dataobj/powernet.h"
+#include "../dataobj/environment.h"
 
 #include "../boden/wege/schiene.h"
 #include "../obj/leitung2.h"
@@ -31,6 +32,27 @@
 
 #include <cmath>
 
+#ifdef MULTI_THREAD
+#include "../utils/simthread.h"
+
+static bool spawned_minimap_threads = false;
+static simthread_barrier_t minimap_barrier_start;
+static simthread_barrier_t minimap_barrier_end;
+
+// protects the maxima of the severity scales while the map is calculated in parallel
+static pthread_mutex_t minimap_maximum_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// to start a thread
+typedef struct {
+	minimap_t *map;
+	sint16 chunk_y_min;
+	sint16 chunk_y_max;
+	bool only_dirty;
+} minimap_thread_param_t;
+
+static minimap_thread_param_t minimap_thread_param[MAX_THREADS];
+#endif
+
 sint32 minimap_t::max_cargo=0;
 sint32 minimap_t::max_passed=0;
 
@@ -46,6 +68,21 @@ static sint32 max_service = 1;
 
 static sint32 max_building_level = 0;
 
+
+// raise a maximum of the severity scales (may be called from several threads)
+static void update_maximum(sint32 &maximum, const sint32 value)
+{
+	if(  value > maximum  ) {
+#ifdef MULTI_THREAD
+		pthread_mutex_lock( &minimap_maximum_mutex );
+#endif
+		maximum = max( maximum, value );
+#ifdef MULTI_THREAD
+		pthread_mutex_unlock( &minimap_maximum_mutex );
+#endif
+	}
+}
+
 minimap_t * minimap_t::single_instance = nullptr;
 karte_ptr_t minimap_t::world;
 
@@ -152,6 +189,19 @@ static uint8 colore_idx = 0;
 static inthashtable_tpl< int, slist_tpl<schedule_t *>, N_BAGS_LARGE> waypoint_hash;
 
 
+minimap_t::schedule_source_t::schedule_source_t( convoihandle_t c ) :
+	cnv(c),
+	schedule(c->get_schedule()),
+	fingerprint(0)
+{
+	// stops and their order, so that an edited schedule is noticed
+	FOR(  minivec_tpl<schedule_entry_t>, const& entry, schedule->entries  ) {
+		fingerprint = fingerprint*31u + (uint32)entry.pos.x*65599u + (uint32)entry.pos.y*257u + (uint32)(uint8)entry.pos.z;
+	}
+	fingerprint = fingerprint*31u + schedule->get_count()*2u + (schedule->is_mirrored() ? 1u : 0u);
+}
+
+
 // add the schedule to the map (if there is a valid one)
 void minimap_t::add_to_schedule_cache( convoihandle_t cnv, bool with_waypoints )
 {
@@ -292,6 +342,116 @@ void minimap_t::add_to_schedule_cache( convoihandle_t cnv, bool with_waypoints )
 
 
 
+void minimap_t::get_schedule_sources( vector_tpl<convoihandle_t> &sources )
+{
+	vector_tpl<linehandle_t> linee;
+
+	for(  int np = 0;  np < MAX_PLAYER_COUNT;  np++  ) {
+		if(  player_showed_on_map != -1  &&  player_showed_on_map != np  ) {
+			continue;
+		}
+		//cycle on players
+		if(  world->get_player( np )  &&  world->get_player( np )->simlinemgmt.get_line_count() > 0   ) {
+
+			world->get_player( np )->simlinemgmt.get_lines( simline_t::line, &linee );
+			for(  uint32 j = 0;  j < linee.get_count();  j++  ) {
+				//cycle on lines
+
+				if (current_halt.is_bound() && !current_halt->registered_lines.is_contained(linee[j])) {
+					continue;
+				}
+
+				if(  transport_type_showed_on_map != simline_t::line  &&  linee[j]->get_linetype() != transport_type_showed_on_map  ) {
+					continue;
+				}
+
+				if(  !is_matching_freight_catg( linee[j]->get_goods_catg_index() )  ) {
+					continue;
+				}
+
+				// ware matches; now find at least a running convoi on this line ...
+				for(  uint32 k = 0;  k < linee[j]->count_convoys();  k++  ) {
+					convoihandle_t test_cnv = linee[j]->get_convoy(k);
+					if(  test_cnv.is_bound()  ) {
+						int state = test_cnv->get_state();
+						if( state != convoi_t::INITIAL  &&  state != convoi_t::ENTERING_DEPOT  &&  state != convoi_t::SELF_DESTRUCT  ) {
+							sources.append( test_cnv );
+							break;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// now add all unbound convois
+	player_t * required_vehicle_owner = nullptr;
+	if (player_showed_on_map != -1) {
+		required_vehicle_owner = world->get_player(player_showed_on_map);
+	}
+	FOR( vector_tpl<convoihandle_t>, cnv, world->convoys() ) {
+		if(  !cnv.is_bound()  ||  cnv->get_line().is_bound()  ) {
+			// not there or already part of a line
+			continue;
+		}
+		if (current_halt.is_bound() && !current_halt->registered_convoys.is_contained(cnv)) {
+			continue;
+		}
+		if(  required_vehicle_owner!= nullptr  &&  required_vehicle_owner != cnv->get_owner()  ) {
+			continue;
+		}
+		if(  transport_type_showed_on_map != simline_t::line  ) {
+			if(  transport_type_showed_on_map != simline_t::waytype_to_linetype(cnv->front()->get_waytype())  ) {
+				continue;
+			}
+		}
+		int state = cnv->get_state();
+		if(  state != convoi_t::INITIAL  &&  state != convoi_t::ENTERING_DEPOT  &&  state != convoi_t::SELF_DESTRUCT  ) {
+			if(  !is_matching_freight_catg(cnv->get_goods_catg_index())  ) {
+				continue;
+			}
+			sources.append( cnv );
+		}
+	}
+}
+
+
+void minimap_t::clear_schedule_cache()
+{
+	schedule_cache.clear();
+	schedule_sources.clear();
+	stop_cache.clear();
+	waypoint_hash.clear();
+	colore_idx = 0;
+}
+
+
+void minimap_t::update_schedule_cache()
+{
+	vector_tpl<convoihandle_t> sources;
+	get_schedule_sources( sources );
+
+	// the schedules already in the cache which did not change
+	uint32 unchanged = 0;
+	while(  unchanged < schedule_sources.get_count()  &&  unchanged < sources.get_count()  &&  schedule_sources[unchanged] == schedule_source_t( sources[unchanged] )  ) {
+		unchanged++;
+	}
+
+	if(  unchanged < schedule_sources.get_count()  ||  stop_cache.empty()  ) {
+		// a schedule was changed or removed: since the offsets of the
+		// segments depend on the order of all schedules, start from scratch
+		clear_schedule_cache();
+		unchanged = 0;
+	}
+
+	// only add the new schedules
+	for(  uint32 i = unchanged;  i < sources.get_count();  i++  ) {
+		schedule_sources.append( schedule_source_t( sources[i] ) );
+		add_to_schedule_cache( sources[i], false );
+	}
+}
+
+
 // some routines for the minimap with schedules
 static uint32 number_to_radius( uint32 n )
 {
@@ -791,10 +951,17 @@ PIXVAL minimap_t::calc_ground_color(const grund_t *gr, bool show_contour, bool s
 void minimap_t::calc_map_pixel(const koord k)
 {
 	// no pixels visible, so noting to calculate
-	if(!is_visible) {
+	if(  !is_visible  ||  dirty_chunks==nullptr  ||  !world->is_within_limits(k)  ) {
 		return;
 	}
+	// only mark it here: the colors are updated in the next draw, all changed tiles at once
+	dirty_chunks->at( k.x/MAP_CHUNK_SIZE, k.y/MAP_CHUNK_SIZE ) = 1;
+	any_chunk_dirty = true;
+}
+
 
+void minimap_t::update_map_pixel(const koord k)
+{
 	// always use to uppermost ground
 	const planquadrat_t *plan=world->access(k);
 	if(plan==nullptr  ||  plan->get_boden_count()==0) {
@@ -869,7 +1036,8 @@ void minimap_t::calc_map_pixel(const koord k)
 			// need to init the maximum?
 			if(max_cargo==0) {
 				max_cargo = 1;
-				calc_map();
+				// redraw when the maximum is known
+				needs_redraw = true;
 			}
 			else if(  gr->hat_wege()  ) {
 				// now calc again ...
@@ -883,9 +1051,7 @@ void minimap_t::calc_map_pixel(const koord k)
 					if(w) {
 						cargo += w->get_statistics(WAY_STAT_GOODS);
 					}
-					if(  cargo > max_cargo  ) {
-						max_cargo = cargo;
-					}
+					update_maximum( max_cargo, cargo );
 					set_map_color(k, calc_severity_color_log(cargo, max_cargo));
 				}
 			}
@@ -896,7 +1062,7 @@ void minimap_t::calc_map_pixel(const koord k)
 			// need to init the maximum?
 			if(  max_passed==0  ) {
 				max_passed = 1;
-				calc_map();
+				needs_redraw = true;
 			}
 			else if(gr->hat_wege()) {
 				// now calc again ...
@@ -909,9 +1075,7 @@ void minimap_t::calc_map_pixel(const koord k)
 					if(  weg_t *w=gr->get_weg_nr(1)  ) {
 						passed += w->get_statistics(WAY_STAT_CONVOIS);
 					}
-					if(  passed > max_passed  ) {
-						max_passed = passed;
-					}
+					update_maximum( max_passed, passed );
 					set_map_color(k, calc_severity_color_log( passed, max_passed ) );
 				}
 			}
@@ -1057,15 +1221,13 @@ void minimap_t::calc_map_pixel(const koord k)
 			if(  max_building_level == 0  ) {
 				// init maximum
 				max_building_level = 1;
-				calc_map();
+				needs_redraw = true;
 			}
 			else if(  gr->get_typ() == grund_t::fundament  ) {
 				if(  gebaeude_t *gb = gr->find<gebaeude_t>()  ) {
 					if(  gb->is_city_building()  ) {
 						sint32 level = gb->get_tile()->get_desc()->get_level();
-						if(  level > max_building_level  ) {
-							max_building_level = level;
-						}
+						update_maximum( max_building_level, level );
 						set_map_color(k, calc_severity_color(level, max_building_level));
 					}
 				}
@@ -1186,6 +1348,107 @@ void minimap_t::calc_map_size()
 }
 
 
+void minimap_t::calc_map_chunks(sint16 chunk_y_min, sint16 chunk_y_max, bool only_dirty)
+{
+	// in isometric mode all tiles are shown, otherwise only every zoom_out-th one
+	const sint16 step = isometric ? 1 : zoom_out;
+	const sint16 chunk_x_min = calc_start.x / MAP_CHUNK_SIZE;
+	const sint16 chunk_x_max = (calc_end.x + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE;
+
+	for(  sint16 cy = chunk_y_min;  cy < chunk_y_max;  cy++  ) {
+		// first row of this chunk on the grid of shown tiles
+		const sint16 dy = cy*MAP_CHUNK_SIZE - calc_start.y;
+		const sint16 y_first = calc_start.y + (dy > 0 ? ((dy + step - 1) / step) * step : 0);
+		const sint16 y_end = min( (sint16)((cy+1)*MAP_CHUNK_SIZE), calc_end.y );
+
+		for(  sint16 cx = chunk_x_min;  cx < chunk_x_max;  cx++  ) {
+			if(  only_dirty  ) {
+				uint8 &dirty = dirty_chunks->at( cx, cy );
+				if(  !dirty  ) {
+					continue;
+				}
+				// reset first, so changes during the update are not lost
+				dirty = 0;
+			}
+			const sint16 dx = cx*MAP_CHUNK_SIZE - calc_start.x;
+			const sint16 x_first = calc_start.x + (dx > 0 ? ((dx + step - 1) / step) * step : 0);
+			const sint16 x_end = min( (sint16)((cx+1)*MAP_CHUNK_SIZE), calc_end.x );
+
+			koord k;
+			for(  k.y = y_first;  k.y < y_end;  k.y += step  ) {
+				for(  k.x = x_first;  k.x < x_end;  k.x += step  ) {
+					update_map_pixel(k);
+				}
+			}
+		}
+	}
+}
+
+
+#ifdef MULTI_THREAD
+void *minimap_t::calc_map_thread(void *ptr)
+{
+	minimap_thread_param_t *param = reinterpret_cast<minimap_thread_param_t *>(ptr);
+	while(true) {
+		simthread_barrier_wait( &minimap_barrier_start ); // wait for all to start
+		param->map->calc_map_chunks( param->chunk_y_min, param->chunk_y_max, param->only_dirty );
+		simthread_barrier_wait( &minimap_barrier_end ); // wait for all to finish
+	}
+	return ptr;
+}
+#endif
+
+
+void minimap_t::calc_map_parallel(bool only_dirty)
+{
+	const sint16 chunk_y_min = calc_start.y / MAP_CHUNK_SIZE;
+	const sint16 chunk_y_max = (calc_end.y + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE;
+#ifdef MULTI_THREAD
+	// in isometric mode the pixels of neighbouring rows overlap,
+	// so neighbouring stripes must not be calculated at the same time
+	const int phases = isometric ? 2 : 1;
+	const int stripes = env_t::num_threads * phases;
+	const sint16 chunk_rows = chunk_y_max - chunk_y_min;
+
+	if(  env_t::num_threads > 1  &&  chunk_rows >= stripes  ) {
+		if(  !spawned_minimap_threads  ) {
+			pthread_t thread[MAX_THREADS];
+			pthread_attr_t attr;
+			pthread_attr_init( &attr );
+			pthread_attr_setdetachstate( &attr, PTHREAD_CREATE_DETACHED );
+			simthread_barrier_init( &minimap_barrier_start, NULL, env_t::num_threads );
+			simthread_barrier_init( &minimap_barrier_end, NULL, env_t::num_threads );
+
+			for(  int t = 0;  t < env_t::num_threads - 1;  t++  ) {
+				if(  pthread_create( &thread[t], &attr, calc_map_thread, (void *)&minimap_thread_param[t] )  ) {
+					dbg->fatal( "minimap_t::calc_map_parallel()", "cannot multithread, error at thread #%i", t+1 );
+				}
+			}
+			spawned_minimap_threads = true;
+			pthread_attr_destroy( &attr );
+		}
+
+		for(  int phase = 0;  phase < phases;  phase++  ) {
+			for(  int t = 0;  t < env_t::num_threads;  t++  ) {
+				const int stripe = t*phases + phase;
+				minimap_thread_param[t].map = this;
+				minimap_thread_param[t].chunk_y_min = chunk_y_min + (stripe * chunk_rows) / stripes;
+				minimap_thread_param[t].chunk_y_max = chunk_y_min + ((stripe + 1) * chunk_rows) / stripes;
+				minimap_thread_param[t].only_dirty = only_dirty;
+			}
+			simthread_barrier_wait( &minimap_barrier_start );
+			// the last one we do ourselves
+			const minimap_thread_param_t &own = minimap_thread_param[env_t::num_threads-1];
+			calc_map_chunks( own.chunk_y_min, own.chunk_y_max, own.only_dirty );
+			simthread_barrier_wait( &minimap_barrier_end );
+		}
+		return;
+	}
+#endif
+	calc_map_chunks( chunk_y_min, chunk_y_max, only_dirty );
+}
+
+
 void minimap_t::calc_map()
 {
 	// only use bitmap size like screen size
@@ -1195,6 +1458,15 @@ void minimap_t::calc_map()
 		delete map_data;
 		map_data = new array2d_tpl<PIXVAL> ( minimap_size.w,minimap_size.h);
 	}
+	const koord chunks( (world->get_size().x + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE, (world->get_size().y + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE );
+	if(  dirty_chunks==nullptr  ||  (sint16)dirty_chunks->get_width()!=chunks.x  ||  (sint16)dirty_chunks->get_height()!=chunks.y  ) {
+		delete dirty_chunks;
+		dirty_chunks = new array2d_tpl<uint8>( chunks.x, chunks.y );
+	}
+	// everything is recalculated anyway
+	dirty_chunks->init( 0 );
+	any_chunk_dirty = false;
+
 	cur_off = new_off;
 	cur_size = new_size;
 	needs_redraw = false;
@@ -1202,26 +1474,24 @@ void minimap_t::calc_map()
 
 	// redraw the map
 	if(  !isometric  ) {
-		koord k;
-		koord start_off = koord( (cur_off.x*zoom_out)/zoom_in, (cur_off.y*zoom_out)/zoom_in );
-		koord end_off = start_off+koord( ( map_data->get_width()*zoom_out)/zoom_in+1, ( map_data->get_height()*zoom_out)/zoom_in+1 );
-		for(  k.y=start_off.y;  k.y<end_off.y;  k.y+=zoom_out  ) {
-			for(  k.x=start_off.x;  k.x<end_off.x;  k.x+=zoom_out  ) {
-				calc_map_pixel(k);
-			}
-		}
+		calc_start = koord( (cur_off.x*zoom_out)/zoom_in, (cur_off.y*zoom_out)/zoom_in );
+		const koord end_off = calc_start+koord( ( map_data->get_width()*zoom_out)/zoom_in+1, ( map_data->get_height()*zoom_out)/zoom_in+1 );
+		calc_end = koord( min( end_off.x, world->get_size().x ), min( end_off.y, world->get_size().y ) );
 	}
 	else {
 		// always the whole map ...
-        map_data->init( color_idx_to_rgb(COL_BLACK) );
-		koord k;
-		for(  k.y=0;  k.y < world->get_size().y;  k.y++  ) {
-			for(  k.x=0;  k.x < world->get_size().x;  k.x++  ) {
-				calc_map_pixel(k);
-			}
-		}
+		map_data->init( color_idx_to_rgb(COL_BLACK) );
+		calc_start = koord( 0, 0 );
+		calc_end = world->get_size();
 	}
+	calc_map_parallel( false );
+
+	calc_map_overlays();
+}
 
+
+void minimap_t::calc_map_overlays()
+{
 	// since we do iterate the tourist info list, this must be done here
 	// find tourist spots
 	if(mode==MAP_TOURIST) {
@@ -1306,6 +1576,9 @@ void minimap_t::init()
 void minimap_t::finalize(){
 	delete map_data;
 	map_data = nullptr;
+	delete dirty_chunks;
+	dirty_chunks = nullptr;
+	any_chunk_dirty = false;
 }
 
 
@@ -1324,8 +1597,13 @@ void minimap_t::new_month()
 
 void minimap_t::invalidate_map_lines_cache()
 {
+	// filters or colors changed, so rebuild from scratch
+	schedule_sources.clear();
 	last_schedule_counter = world->get_schedule_counter() - 1;
-	needs_redraw = true;
+	if(  mode & MAP_STATION_COVERAGE  ) {
+		// coverage uses the same filters
+		needs_redraw = true;
+	}
 }
 
 
@@ -1403,9 +1681,7 @@ void minimap_t::set_selected_cnv( convoihandle_t c )
 {
 	current_cnv = c;
 	current_halt = halthandle_t();
-	schedule_cache.clear();
-	stop_cache.clear();
-	colore_idx = 0;
+	clear_schedule_cache();
 	add_to_schedule_cache( current_cnv, true );
 	last_schedule_counter = world->get_schedule_counter()-1;
 }
@@ -1436,14 +1712,14 @@ void minimap_t::draw(scr_coord pos)
 			// rebuilt stop_cache needed
 			stop_cache.clear();
 			if(  (mode & MAP_LINES)  &&  (last_mode & MAP_LINES)  &&  current_cnv.is_bound()  ) {
-				schedule_cache.clear();
+				clear_schedule_cache();
 				add_to_schedule_cache(current_cnv, true);
 				needs_redraw = true;
 			}
 		}
 
 		if(  (mode & MAP_LINES)  &&  (last_mode & MAP_LINES) == 0  &&  current_cnv.is_bound()  ) {
-			schedule_cache.clear();
+			clear_schedule_cache();
 			add_to_schedule_cache(current_cnv, true);
 			needs_redraw = true;
 		}
@@ -1458,7 +1734,12 @@ void minimap_t::draw(scr_coord pos)
 
 	if(  needs_redraw  ||  cur_off!=new_off  ||  cur_size!=new_size  ) {
 		calc_map();
-		needs_redraw = false;
+	}
+	else if(  any_chunk_dirty  ) {
+		// only the tiles changed since the last draw
+		any_chunk_dirty = false;
+		calc_map_parallel( true );
+		calc_map_overlays();
 	}
 
 	if( map_data==NULL) {
@@ -1503,91 +1784,9 @@ void minimap_t::draw(scr_coord pos)
 	display_array_wh( cur_off.x+pos.x, new_off.y+pos.y, map_data->get_width(), map_data->get_height(), map_data->to_array());
 
 	if(  !current_cnv.is_bound()  &&  mode & MAP_LINES    ) {
-		vector_tpl<linehandle_t> linee;
-
 		if(  last_schedule_counter != world->get_schedule_counter()  ) {
-			// rebuild cache
 			last_schedule_counter = world->get_schedule_counter();
-			schedule_cache.clear();
-			stop_cache.clear();
-			waypoint_hash.clear();
-			colore_idx = 0;
-
-			for(  int np = 0;  np < MAX_PLAYER_COUNT;  np++  ) {
-				if(  player_showed_on_map != -1  &&  player_showed_on_map != np  ) {
-					continue;
-				}
-				//cycle on players
-				if(  world->get_player( np )  &&  world->get_player( np )->simlinemgmt.get_line_count() > 0   ) {
-
-					world->get_player( np )->simlinemgmt.get_lines( simline_t::line, &linee );
-					for(  uint32 j = 0;  j < linee.get_count();  j++  ) {
-						//cycle on lines
-
-						if (current_halt.is_bound() && !current_halt->registered_lines.is_contained(linee[j])) {
-							continue;
-						}
-
-						if(  transport_type_showed_on_map != simline_t::line  &&  linee[j]->get_linetype() != transport_type_showed_on_map  ) {
-							continue;
-						}
-
-						if(  !is_matching_freight_catg( linee[j]->get_goods_catg_index() )  ) {
-							continue;
-						}
-
-						// ware matches; now find at least a running convoi on this line ...
-						convoihandle_t cnv;
-						for(  uint32 k = 0;  k < linee[j]->count_convoys();  k++  ) {
-							convoihandle_t test_cnv = linee[j]->get_convoy(k);
-							if(  test_cnv.is_bound()  ) {
-								int state = test_cnv->get_state();
-								if( state != convoi_t::INITIAL  &&  state != convoi_t::ENTERING_DEPOT  &&  state != convoi_t::SELF_DESTRUCT  ) {
-									cnv = test_cnv;
-									break;
-								}
-							}
-						}
-						if(  !cnv.is_bound()  ) {
-							continue;
-						}
-						int state = cnv->get_state();
-						if( state != convoi_t::INITIAL  &&  state != convoi_t::ENTERING_DEPOT  &&  state != convoi_t::SELF_DESTRUCT  ) {
-							add_to_schedule_cache( cnv, false );
-						}
-					}
-				}
-			}
-
-			// now add all unbound convois
-			player_t * required_vehicle_owner = nullptr;
-			if (player_showed_on_map != -1) {
-				required_vehicle_owner = world->get_player(player_showed_on_map);
-			}
-			FOR( vector_tpl<convoihandle_t>, cnv, world->convoys() ) {
-				if(  !cnv.is_bound()  ||  cnv->get_line().is_bound()  ) {
-					// not there or already part of a line
-					continue;
-				}
-				if (current_halt.is_bound() && !current_halt->registered_convoys.is_contained(cnv)) {
-					continue;
-				}
-				if(  required_vehicle_owner!= nullptr  &&  required_vehicle_owner != cnv->get_owner()  ) {
-					continue;
-				}
-				if(  transport_type_showed_on_map != simline_t::line  ) {
-					if(  transport_type_showed_on_map != simline_t::waytype_to_linetype(cnv->front()->get_waytype())  ) {
-						continue;
-					}
-				}
-				int state = cnv->get_state();
-				if(  state != convoi_t::INITIAL  &&  state != convoi_t::ENTERING_DEPOT  &&  state != convoi_t::SELF_DESTRUCT  ) {
-					if(  !is_matching_freight_catg(cnv->get_goods_catg_index())  ) {
-						continue;
-					}
-					add_to_schedule_cache( cnv, false );
-				}
-			}
+			update_schedule_cache();
 		}
 		/************ ATTENTION: The schedule pointers schedule in the line segments ******************
 		 ************            are invalid after this point!                       ******************/
@@ -1600,6 +1799,7 @@ void minimap_t::draw(scr_coord pos)
 	}
 	else {
 		schedule_cache.clear();
+		schedule_sources.clear();
 		colore_idx = 0;
 		last_schedule_counter = world->get_schedule_counter()-1;
 	}
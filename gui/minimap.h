@@ -86,6 +86,16 @@ private:
 	/// the terrain map
 	array2d_tpl<PIXVAL> *map_data{nullptr};
 
+	/// tiles per side of one block of the dirty map
+	enum { MAP_CHUNK_SIZE = 8 };
+
+	/// one flag per block of MAP_CHUNK_SIZE x MAP_CHUNK_SIZE tiles changed since the last draw
+	array2d_tpl<uint8> *dirty_chunks{nullptr};
+	bool any_chunk_dirty{false};
+
+	/// tile range (stepped by zoom_out) of the map part currently computed
+	koord calc_start, calc_end;
+
 	/// nonstatic, if we have someday many maps ...
 	void set_map_color_clip( sint16 x, sint16 y, PIXVAL color );
 
@@ -134,6 +144,24 @@ private:
 	};
 
 	vector_tpl<line_segment_t> schedule_cache;
+
+	/// convoys whose schedules are in schedule_cache, in the order they were added
+	class schedule_source_t
+	{
+	public:
+		convoihandle_t cnv;
+		const schedule_t *schedule;
+		uint32 fingerprint;
+
+		schedule_source_t() : schedule(nullptr), fingerprint(0) {}
+		schedule_source_t( convoihandle_t c );
+
+		bool operator==(const schedule_source_t &other) const {
+			return cnv == other.cnv  &&  schedule == other.schedule  &&  fingerprint == other.fingerprint;
+		}
+	};
+	vector_tpl<schedule_source_t> schedule_sources;
+
 	convoihandle_t current_cnv;
 	halthandle_t current_halt;
 	uint8 last_schedule_counter{};
@@ -142,6 +170,15 @@ private:
 	/// adds a schedule to cache
 	void add_to_schedule_cache( convoihandle_t cnv, bool with_waypoints );
 
+	/// collects the convoys whose schedules should be shown in MAP_LINES mode
+	void get_schedule_sources( vector_tpl<convoihandle_t> &sources );
+
+	/// updates schedule_cache, only adding schedules if the old ones are unchanged
+	void update_schedule_cache();
+
+	/// empties schedule_cache and everything derived from it
+	void clear_schedule_cache();
+
 	/**
 	 * //TODO Why are the following two static?
 	 * 0: normal
@@ -194,6 +231,20 @@ private:
 
 	void set_map_color(koord k, PIXVAL color);
 
+	/// recalculates the color of a single tile
+	void update_map_pixel(koord k);
+
+	/// recalculates all (or only the dirty) chunks in the rows [chunk_y_min, chunk_y_max)
+	void calc_map_chunks(sint16 chunk_y_min, sint16 chunk_y_max, bool only_dirty);
+
+	/// distributes calc_map_chunks() over all threads
+	void calc_map_parallel(bool only_dirty);
+
+	/// draws the markers of attractions, factories or depots of the special maps
+	void calc_map_overlays();
+
+	static void *calc_map_thread(void *ptr);
+
 public:
 	scr_coord map_to_screen_coord(const koord &k) const;
 
@@ -238,7 +289,10 @@ public:
 		new_size = size;
 	}
 
-	/// update color with render mode (but few are ignored ... )
+	/**
+	 * Marks the tile as changed, its color will be updated on the next draw.
+	 * Can be called from any thread.
+	 */
 	void calc_map_pixel(koord k);
 
 	void calc_map();
@@ -261,6 +315,9 @@ public:
 
 	void invalidate_map_lines_cache();
 
+	/// forces a recalculation of all pixels on the next draw
+	void invalidate_map() { needs_redraw = true; }
+
 	bool infowin_event(event_t const*) OVERRIDE;
 
 	void draw(scr_coord pos) OVERRIDE;
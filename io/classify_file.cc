@@ -6,6 +6,7 @@
 #include "classify_file.h"
 
 #include "rdwr/bzip2_file_rdwr_stream.h"
+#include "rdwr/delta_file_rdwr_stream.h"
 #include "rdwr/raw_file_rdwr_stream.h"
 #include "rdwr/zlib_file_rdwr_stream.h"
 #if USE_ZSTD
@@ -86,6 +87,20 @@ file_classify_status_t classify_file(const char *path, file_info_t *info)
 		return FILE_CLASSIFY_OK;
 	}
 
+	fseek(f, 0, SEEK_SET);
+	if (delta_file_rdwr_stream_t::is_delta_file(f)) {
+		fclose(f);
+
+		info->file_type = file_info_t::TYPE_DELTA;
+		delta_file_rdwr_stream_t s(path, false);
+		if (s.get_status() != rdwr_stream_t::STATUS_OK  ||  !classify_file_data(&s, info)) {
+			info->ext_version = extended_version_t::INVALID;
+			info->header_size = 0;
+		}
+
+		return FILE_CLASSIFY_OK;
+	}
+
 	fseek(f, 0, SEEK_SET);
 	if (classify_as_bzip2(f, info)) {
 		fclose(f);
@@ -43,6 +43,7 @@ struct file_info_t
 		TYPE_ZIPPED,  // zipped save
 		TYPE_BZIP2,   // bzip2 compressed save
 		TYPE_ZSTD,    // zstd compressed save
+		TYPE_DELTA,   // difference to another save
 
 		TYPE_PNG,     // PNG image
 		TYPE_BMP,
@@ -53,7 +54,8 @@ struct file_info_t
 		// Combined file formats
 		TYPE_XML_ZIPPED = TYPE_XML | TYPE_ZIPPED,
 		TYPE_XML_BZIP2  = TYPE_XML | TYPE_BZIP2,
-		TYPE_XML_ZSTD   = TYPE_XML | TYPE_ZSTD
+		TYPE_XML_ZSTD   = TYPE_XML | TYPE_ZSTD,
+		TYPE_XML_DELTA  = TYPE_XML | TYPE_DELTA
 	};
 
 public:
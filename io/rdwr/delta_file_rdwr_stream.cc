@@ -0,0 +1,565 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include "delta_file_rdwr_stream.h"
+
+#include "bzip2_file_rdwr_stream.h"
+#include "raw_file_rdwr_stream.h"
+#include "zlib_file_rdwr_stream.h"
+#ifdef USE_ZSTD
+#include "zstd_file_rdwr_stream.h"
+#endif
+
+#include "../classify_file.h"
+#include "../../sys/simsys.h"
+#include "../../tpl/vector_tpl.h"
+#include "../../macros.h"
+#include "../../simdebug.h"
+#include "../../simmem.h"
+
+#include <algorithm>
+#include <cassert>
+#include <string.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+
+#define DELTA_MAGIC "DL"
+#define DELTA_FORMAT_VERSION (1)
+
+// content defined chunks: at least 2 KiB, on average 8 KiB, at most 64 KiB
+#define CHUNK_MIN_SIZE (1 << 11)
+#define CHUNK_MAX_SIZE (1 << 16)
+#define CHUNK_BORDER_BITS (13)
+
+// operations are deflated in blocks of this size
+#define OPS_BLOCK_SIZE (1 << 16)
+#define OUT_BUFFER_SIZE (1 << 16)
+
+enum { OP_COPY = 0, OP_DATA = 1 };
+
+
+static uint32 get_le32(const uint8 *p)
+{
+	return (uint32)p[0] | ((uint32)p[1] << 8) | ((uint32)p[2] << 16) | ((uint32)p[3] << 24);
+}
+
+
+static void put_le32(uint8 *p, uint32 x)
+{
+	p[0] = x & 0xFF;
+	p[1] = (x >> 8) & 0xFF;
+	p[2] = (x >> 16) & 0xFF;
+	p[3] = (x >> 24) & 0xFF;
+}
+
+
+static void append_le32(vector_tpl<uint8> &v, uint32 x)
+{
+	v.append( x & 0xFF );
+	v.append( (x >> 8) & 0xFF );
+	v.append( (x >> 16) & 0xFF );
+	v.append( (x >> 24) & 0xFF );
+}
+
+
+/// random values for the rolling gear hash, the same on every platform
+static const uint64 *get_gear_table()
+{
+	static uint64 gear[256];
+	static bool initialized = false;
+	if(  !initialized  ) {
+		// splitmix64
+		uint64 x = 0x5A17DE17A5A5E5ULL;
+		for(  int i = 0;  i < 256;  i++  ) {
+			x += 0x9E3779B97F4A7C15ULL;
+			uint64 z = x;
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			gear[i] = z ^ (z >> 31);
+		}
+		initialized = true;
+	}
+	return gear;
+}
+
+
+/// @returns length of the chunk starting at @p p
+static size_t next_chunk_length(const uint8 *p, size_t len)
+{
+	if(  len <= CHUNK_MIN_SIZE  ) {
+		return len;
+	}
+	const uint64 *gear = get_gear_table();
+	const size_t max_len = min( len, (size_t)CHUNK_MAX_SIZE );
+	uint64 h = 0;
+	for(  size_t i = CHUNK_MIN_SIZE;  i < max_len;  i++  ) {
+		h = (h << 1) + gear[p[i]];
+		if(  (h >> (64 - CHUNK_BORDER_BITS)) == 0  ) {
+			return i + 1;
+		}
+	}
+	return max_len;
+}
+
+
+static uint64 chunk_hash(const uint8 *p, size_t len)
+{
+	// FNV-1a
+	uint64 h = 0xCBF29CE484222325ULL;
+	for(  size_t i = 0;  i < len;  i++  ) {
+		h = (h ^ p[i]) * 0x100000001B3ULL;
+	}
+	return h;
+}
+
+
+struct base_chunk_t
+{
+	uint64 hash;
+	uint32 offset;
+	uint32 length;
+
+	bool operator <(const base_chunk_t &other) const { return hash < other.hash; }
+};
+
+
+/// uncompressed base savegame with its chunks sorted by hash
+struct delta_base_t
+{
+	std::string path;
+	sint64 file_size;
+	sint64 file_time;
+	uint8 *data;
+	size_t size;
+	uint32 checksum;
+	vector_tpl<base_chunk_t> chunks;
+
+	delta_base_t() : file_size(-1), file_time(0), data(NULL), size(0), checksum(0) {}
+};
+
+/// the base of the last written delta; all deltas up to the next full save share it
+static delta_base_t cached_base;
+
+
+bool delta_file_rdwr_stream_t::is_delta_file(FILE *f)
+{
+	char buf[2];
+	return fread( buf, 1, 2, f ) == 2  &&  memcmp( buf, DELTA_MAGIC, 2 ) == 0;
+}
+
+
+/// @returns the uncompressed savegame @p filename, or NULL for deltas and unknown formats
+static rdwr_stream_t *open_base_stream(const std::string &filename)
+{
+	file_info_t info;
+	if(  classify_file( filename.c_str(), &info ) != FILE_CLASSIFY_OK  ) {
+		return NULL;
+	}
+
+	switch(  info.file_type & ~file_info_t::TYPE_XML  ) {
+		case file_info_t::TYPE_DELTA:  return NULL; // no chains of deltas
+#ifdef USE_ZSTD
+		case file_info_t::TYPE_ZSTD:   return new zstd_file_rdwr_stream_t( filename, false, 0 );
+#else
+		case file_info_t::TYPE_ZSTD:   return NULL;
+#endif
+		case file_info_t::TYPE_BZIP2:  return new bzip2_file_rdwr_stream_t( filename, false );
+		case file_info_t::TYPE_ZIPPED: return new zlib_file_rdwr_stream_t( filename, false, 0 );
+		default:                       return new raw_file_rdwr_stream_t( filename, false );
+	}
+}
+
+
+/// reads the uncompressed content of the savegame @p filename into @p base
+static bool read_base(const std::string &filename, uint8 *&base, size_t &base_size)
+{
+	rdwr_stream_t *s = open_base_stream( filename );
+	if(  s == NULL  ) {
+		return false;
+	}
+
+	size_t capacity = 0;
+	while(  s->get_status() == rdwr_stream_t::STATUS_OK  ) {
+		if(  base_size == capacity  ) {
+			capacity = max( capacity * 2, (size_t)(1 << 20) );
+			base = REALLOC( base, uint8, capacity );
+		}
+		base_size += s->read( base + base_size, capacity - base_size );
+	}
+	const bool ok = s->get_status() == rdwr_stream_t::STATUS_EOF  &&  base_size <= 0xFFFFFFFFu;
+	delete s;
+	return ok;
+}
+
+
+/// @returns the base @p filename with its chunk index, only read again if the file was changed
+static const delta_base_t *get_cached_base(const std::string &filename)
+{
+	struct stat st;
+	if(  dr_stat( filename.c_str(), &st ) != 0  ) {
+		return NULL;
+	}
+	if(  cached_base.data  &&  cached_base.path == filename  &&  cached_base.file_size == (sint64)st.st_size  &&  cached_base.file_time == (sint64)st.st_mtime  ) {
+		return &cached_base;
+	}
+
+	free( cached_base.data );
+	cached_base.data = NULL;
+	cached_base.size = 0;
+	cached_base.chunks.clear();
+	if(  !read_base( filename, cached_base.data, cached_base.size )  ) {
+		free( cached_base.data );
+		cached_base.data = NULL;
+		cached_base.size = 0;
+		return NULL;
+	}
+	cached_base.path = filename;
+	cached_base.file_size = st.st_size;
+	cached_base.file_time = st.st_mtime;
+	cached_base.checksum = adler32( adler32( 0, NULL, 0 ), cached_base.data, (uInt)cached_base.size );
+
+	const uint8 *base = cached_base.data;
+	const size_t base_size = cached_base.size;
+	cached_base.chunks.resize( base_size / (CHUNK_MIN_SIZE * 2) + 1 );
+	for(  size_t pos = 0;  pos < base_size;  ) {
+		base_chunk_t c;
+		c.offset = (uint32)pos;
+		c.length = (uint32)next_chunk_length( base + pos, base_size - pos );
+		c.hash = chunk_hash( base + pos, c.length );
+		cached_base.chunks.append( c );
+		pos += c.length;
+	}
+	std::sort( cached_base.chunks.begin(), cached_base.chunks.end() );
+	return &cached_base;
+}
+
+
+delta_file_rdwr_stream_t::delta_file_rdwr_stream_t(const std::string &filename, bool writing, const std::string &base_filename) :
+	rdwr_stream_t(writing),
+	fp(NULL),
+	data(NULL),
+	data_size(0),
+	read_pos(0),
+	pending(NULL),
+	pending_start(0),
+	pending_end(0),
+	written(0),
+	copy_offset(0),
+	copy_length(0),
+	ops(NULL),
+	ops_size(0),
+	out(NULL),
+	zs_open(false),
+	compressed_size(0),
+	sizes_pos(0)
+{
+	// the base is always next to the delta
+	const size_t dir_len = filename.find_last_of( "/\\" ) + 1;
+
+	fp = dr_fopen( filename.c_str(), writing ? "wb" : "rb" );
+	if(  fp == NULL  ) {
+		status = writing ? STATUS_ERR_FULL : STATUS_ERR_NOT_EXISTING;
+		return;
+	}
+
+	if(  writing  ) {
+		base_name = base_filename.substr( base_filename.find_last_of( "/\\" ) + 1 );
+		base_path = filename.substr( 0, dir_len ) + base_name;
+		const delta_base_t *base = get_cached_base( base_path );
+		if(  base == NULL  ) {
+			status = STATUS_ERR_NOT_EXISTING;
+			return;
+		}
+
+		// the sizes are filled in when the stream is closed
+		vector_tpl<uint8> header( base_name.size() + 32 );
+		header.append( DELTA_MAGIC[0] );
+		header.append( DELTA_MAGIC[1] );
+		header.append( DELTA_FORMAT_VERSION );
+		header.append( base_name.size() & 0xFF );
+		header.append( (base_name.size() >> 8) & 0xFF );
+		for(  size_t i = 0;  i < base_name.size();  i++  ) {
+			header.append( base_name[i] );
+		}
+		append_le32( header, (uint32)base->size );
+		append_le32( header, base->checksum );
+		sizes_pos = header.get_count();
+		append_le32( header, 0 );
+		append_le32( header, 0 );
+		if(  fwrite( header.begin(), 1, header.get_count(), fp ) != header.get_count()  ) {
+			status = STATUS_ERR_FULL;
+			return;
+		}
+
+		MEMZERO( zs );
+		if(  deflateInit( &zs, Z_BEST_SPEED ) != Z_OK  ) {
+			status = STATUS_ERR_CORRUPT;
+			return;
+		}
+		zs_open = true;
+		pending = MALLOCN( uint8, 2 * CHUNK_MAX_SIZE );
+		ops = MALLOCN( uint8, OPS_BLOCK_SIZE + 9 + CHUNK_MAX_SIZE );
+		out = MALLOCN( uint8, OUT_BUFFER_SIZE );
+		status = STATUS_OK;
+		return;
+	}
+
+	// header: magic, version, base name, base size and checksum, restored size, compressed size
+	uint8 header[5];
+	if(  fread( header, 1, 5, fp ) != 5  ||  memcmp( header, DELTA_MAGIC, 2 ) != 0  ||  header[2] != DELTA_FORMAT_VERSION  ) {
+		status = STATUS_ERR_CORRUPT;
+		return;
+	}
+	const uint16 name_len = header[3] | (header[4] << 8);
+	char *name = new char[name_len + 1];
+	uint8 sizes[16];
+	const bool ok = fread( name, 1, name_len, fp ) == name_len  &&  fread( sizes, 1, 16, fp ) == 16;
+	name[name_len] = 0;
+	base_name = name;
+	delete [] name;
+	if(  !ok  ) {
+		status = STATUS_ERR_CORRUPT;
+		return;
+	}
+	base_path = filename.substr( 0, dir_len ) + base_name;
+
+	uint8 *base = NULL;
+	size_t base_size = 0;
+	if(  !read_base( base_path, base, base_size )  ) {
+		free( base );
+		dbg->warning( "delta_file_rdwr_stream_t", "Cannot read base savegame '%s'", base_path.c_str() );
+		status = STATUS_ERR_NOT_EXISTING;
+		return;
+	}
+	if(  base_size != get_le32( sizes )  ||  adler32( adler32( 0, NULL, 0 ), base, (uInt)base_size ) != get_le32( sizes + 4 )  ) {
+		dbg->warning( "delta_file_rdwr_stream_t", "Base savegame '%s' was changed", base_path.c_str() );
+		free( base );
+		status = STATUS_ERR_CORRUPT;
+		return;
+	}
+
+	// uncompress the operations
+	const uint32 restored_size = get_le32( sizes + 8 );
+	const uint32 ops_compressed = get_le32( sizes + 12 );
+	uint8 *compressed = MALLOCN( uint8, ops_compressed );
+	if(  fread( compressed, 1, ops_compressed, fp ) != ops_compressed  ) {
+		free( compressed );
+		free( base );
+		status = STATUS_ERR_CORRUPT;
+		return;
+	}
+	// operations never take more than the restored data plus nine bytes per chunk
+	uLongf ops_length = restored_size + (restored_size / CHUNK_MIN_SIZE + 2) * 9;
+	uint8 *op_data = MALLOCN( uint8, ops_length );
+	const int ret = uncompress( op_data, &ops_length, compressed, ops_compressed );
+	free( compressed );
+
+	// apply them
+	data = MALLOCN( uint8, max( restored_size, (uint32)1 ) );
+	bool valid = ret == Z_OK;
+	size_t pos = 0;
+	while(  valid  &&  pos < ops_length  ) {
+		const uint8 op = op_data[pos];
+		if(  op == OP_COPY  &&  pos + 9 <= ops_length  ) {
+			const uint32 offset = get_le32( op_data + pos + 1 );
+			const uint32 length = get_le32( op_data + pos + 5 );
+			valid = (size_t)offset + length <= base_size  &&  data_size + length <= restored_size;
+			if(  valid  ) {
+				memcpy( data + data_size, base + offset, length );
+				data_size += length;
+			}
+			pos += 9;
+		}
+		else if(  op == OP_DATA  &&  pos + 5 <= ops_length  ) {
+			const uint32 length = get_le32( op_data + pos + 1 );
+			valid = pos + 5 + length <= ops_length  &&  data_size + length <= restored_size;
+			if(  valid  ) {
+				memcpy( data + data_size, op_data + pos + 5, length );
+				data_size += length;
+			}
+			pos += 5 + length;
+		}
+		else {
+			valid = false;
+		}
+	}
+	free( op_data );
+
+	// the base is not needed any more
+	free( base );
+
+	status = valid  &&  data_size == restored_size ? STATUS_OK : STATUS_ERR_CORRUPT;
+}
+
+
+delta_file_rdwr_stream_t::~delta_file_rdwr_stream_t()
+{
+	if(  fp  ) {
+		if(  is_writing()  &&  status == STATUS_OK  ) {
+			finish_delta();
+		}
+		fclose( fp );
+	}
+	if(  zs_open  ) {
+		deflateEnd( &zs );
+	}
+	free( data );
+	free( pending );
+	free( ops );
+	free( out );
+}
+
+
+size_t delta_file_rdwr_stream_t::read(void *buf, size_t len)
+{
+	assert(!is_writing());
+
+	const size_t n = min( len, data_size - read_pos );
+	memcpy( buf, data + read_pos, n );
+	read_pos += n;
+	status = n == len ? STATUS_OK : STATUS_EOF;
+	return n;
+}
+
+
+size_t delta_file_rdwr_stream_t::write(const void *buf, size_t len)
+{
+	assert(is_writing());
+
+	if(  status != STATUS_OK  ) {
+		return 0;
+	}
+
+	const uint8 *src = (const uint8 *)buf;
+	size_t left = len;
+	while(  left > 0  ) {
+		// less than CHUNK_MAX_SIZE bytes are pending here, so this leaves room for more
+		if(  pending_end == 2 * CHUNK_MAX_SIZE  ) {
+			memmove( pending, pending + pending_start, pending_end - pending_start );
+			pending_end -= pending_start;
+			pending_start = 0;
+		}
+		const size_t n = min( left, 2 * CHUNK_MAX_SIZE - pending_end );
+		memcpy( pending + pending_end, src, n );
+		pending_end += n;
+		src += n;
+		left -= n;
+		if(  !process_pending( false )  ) {
+			return len - left;
+		}
+	}
+	return len;
+}
+
+
+bool delta_file_rdwr_stream_t::process_pending(bool final)
+{
+	// chunk borders depend only on the next CHUNK_MAX_SIZE bytes
+	while(  pending_end - pending_start >= CHUNK_MAX_SIZE  ||  (final  &&  pending_end > pending_start)  ) {
+		const uint8 *p = pending + pending_start;
+		const size_t length = next_chunk_length( p, pending_end - pending_start );
+		if(  written + length > 0xFFFFFFFFu  ) {
+			status = STATUS_ERR_FULL;
+			return false;
+		}
+
+		base_chunk_t key;
+		key.hash = chunk_hash( p, length );
+		const base_chunk_t *match = NULL;
+		for(  const base_chunk_t *c = std::lower_bound( cached_base.chunks.begin(), cached_base.chunks.end(), key );  c != cached_base.chunks.end()  &&  c->hash == key.hash;  c++  ) {
+			if(  c->length == length  &&  memcmp( cached_base.data + c->offset, p, length ) == 0  ) {
+				match = c;
+				break;
+			}
+		}
+
+		// extend the pending copy, if possible
+		if(  copy_length > 0  &&  (match == NULL  ||  match->offset != copy_offset + copy_length)  ) {
+			if(  !add_op( OP_COPY, copy_offset, copy_length )  ) {
+				return false;
+			}
+			copy_length = 0;
+		}
+		if(  match  ) {
+			if(  copy_length == 0  ) {
+				copy_offset = match->offset;
+			}
+			copy_length += (uint32)length;
+		}
+		else if(  !add_op( OP_DATA, (uint32)length, 0, p )  ) {
+			return false;
+		}
+
+		pending_start += length;
+		written += length;
+	}
+	return true;
+}
+
+
+bool delta_file_rdwr_stream_t::add_op(uint8 op, uint32 a, uint32 b, const uint8 *bytes)
+{
+	ops[ops_size] = op;
+	put_le32( ops + ops_size + 1, a );
+	if(  op == OP_COPY  ) {
+		put_le32( ops + ops_size + 5, b );
+		ops_size += 9;
+	}
+	else {
+		memcpy( ops + ops_size + 5, bytes, a );
+		ops_size += 5 + a;
+	}
+	return ops_size < OPS_BLOCK_SIZE  ||  deflate_ops( Z_NO_FLUSH );
+}
+
+
+bool delta_file_rdwr_stream_t::deflate_ops(int flush)
+{
+	zs.next_in = ops;
+	zs.avail_in = (uInt)ops_size;
+	int ret;
+	do {
+		zs.next_out = out;
+		zs.avail_out = OUT_BUFFER_SIZE;
+		ret = deflate( &zs, flush );
+		if(  ret == Z_STREAM_ERROR  ) {
+			dbg->error( "delta_file_rdwr_stream_t::deflate_ops", "Error during compression" );
+			status = STATUS_ERR_CORRUPT;
+			return false;
+		}
+		const size_t n = OUT_BUFFER_SIZE - zs.avail_out;
+		if(  fwrite( out, 1, n, fp ) != n  ||  compressed_size + n > 0xFFFFFFFFu  ) {
+			status = STATUS_ERR_FULL;
+			return false;
+		}
+		compressed_size += (uint32)n;
+	} while(  zs.avail_out == 0  ||  (flush == Z_FINISH  &&  ret != Z_STREAM_END)  );
+	ops_size = 0;
+	return true;
+}
+
+
+bool delta_file_rdwr_stream_t::finish_delta()
+{
+	if(  !process_pending( true )  ) {
+		return false;
+	}
+	if(  copy_length > 0  &&  !add_op( OP_COPY, copy_offset, copy_length )  ) {
+		return false;
+	}
+	if(  !deflate_ops( Z_FINISH )  ) {
+		return false;
+	}
+
+	uint8 sizes[8];
+	put_le32( sizes, (uint32)written );
+	put_le32( sizes + 4, compressed_size );
+	if(  fseek( fp, sizes_pos, SEEK_SET ) != 0  ||  fwrite( sizes, 1, 8, fp ) != 8  ) {
+		status = STATUS_ERR_FULL;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,83 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef IO_RDWR_DELTA_FILE_RDWR_STREAM_H
+#define IO_RDWR_DELTA_FILE_RDWR_STREAM_H
+
+
+#include "rdwr_stream.h"
+
+#include <cstdio>
+#include <zlib.h>
+
+
+/// Reads/writes a savegame as difference to another (base) savegame.
+///
+/// The uncompressed data is cut into content defined chunks. Chunks also found in the
+/// base are stored as references, only the others are stored (deflate compressed).
+/// Since the chunk borders depend on the content only, data inserted or removed
+/// somewhere in the savegame does not shift all following chunks.
+///
+/// The base is looked up in the directory of the delta file and may be any savegame,
+/// but not a delta itself. When writing, the chunks are compared while the data
+/// arrives; the uncompressed base and its chunk index are kept until a delta
+/// against another base is written. When reading, the restored savegame is held in memory.
+class delta_file_rdwr_stream_t : public rdwr_stream_t
+{
+public:
+	/// @param base_filename name of the base savegame; only used for writing
+	delta_file_rdwr_stream_t(const std::string &filename, bool writing, const std::string &base_filename = "");
+	~delta_file_rdwr_stream_t();
+
+public:
+	/// @copydoc rdwr_stream_t::read
+	size_t read(void *buf, size_t len) OVERRIDE;
+
+	/// @copydoc rdwr_stream_t::write
+	size_t write(const void *buf, size_t len) OVERRIDE;
+
+	/// @returns true if @p f (positioned at its start) is a delta savegame
+	static bool is_delta_file(FILE *f);
+
+private:
+	/// cuts all complete chunks from pending; with @p final also the rest
+	bool process_pending(bool final);
+
+	/// appends an operation to ops and deflates them, if enough are collected
+	bool add_op(uint8 op, uint32 a, uint32 b, const uint8 *bytes = NULL);
+
+	/// deflates ops and writes the result; @p flush is Z_NO_FLUSH or Z_FINISH
+	bool deflate_ops(int flush);
+
+	/// flushes the remaining data and completes the header
+	bool finish_delta();
+
+	FILE *fp;
+	std::string base_name; ///< without path
+	std::string base_path; ///< with path of the delta
+
+	// reading
+	uint8 *data;         ///< the restored savegame
+	size_t data_size;
+	size_t read_pos;
+
+	// writing
+	uint8 *pending;      ///< new data not yet cut into chunks
+	size_t pending_start;
+	size_t pending_end;
+	uint64 written;      ///< uncompressed size of the new savegame
+	uint32 copy_offset;  ///< not yet written copy operation
+	uint32 copy_length;
+	uint8 *ops;          ///< not yet compressed operations
+	size_t ops_size;
+	uint8 *out;
+	z_stream zs;
+	bool zs_open;
+	uint32 compressed_size;
+	long sizes_pos;      ///< file position of the restored and compressed sizes in the header
+};
+
+
+#endif
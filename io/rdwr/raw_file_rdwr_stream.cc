@@ -10,8 +10,9 @@
 #include <cassert>
 
 
-raw_file_rdwr_stream_t::raw_file_rdwr_stream_t(const std::string &filename, bool writing) :
-	rdwr_stream_t(writing)
+raw_file_rdwr_stream_t::raw_file_rdwr_stream_t(const std::string &filename, bool writing, rdwr_stream_t *tee) :
+	rdwr_stream_t(writing),
+	tee(tee)
 {
 	file = dr_fopen(filename.c_str(), writing ? "wb" : "rb");
 	if (!file) {
@@ -24,7 +25,8 @@ raw_file_rdwr_stream_t::raw_file_rdwr_stream_t(const std::string &filename, bool
 
 raw_file_rdwr_stream_t::raw_file_rdwr_stream_t(FILE *f, bool writing) :
 	rdwr_stream_t(writing),
-	file(f)
+	file(f),
+	tee(NULL)
 {
 	if (!file) {
 		status = STATUS_ERR_NOT_EXISTING;
@@ -75,6 +77,9 @@ size_t raw_file_rdwr_stream_t::write(const void *buf, size_t len)
 
 	if (bytes_written == len) {
 		status = STATUS_OK;
+		if (tee  &&  len > 0  &&  tee->get_status() == STATUS_OK) {
+			tee->write(buf, len);
+		}
 	}
 	else {
 		status = STATUS_ERR_FULL;
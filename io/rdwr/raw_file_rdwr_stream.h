@@ -16,7 +16,9 @@
 class raw_file_rdwr_stream_t : public rdwr_stream_t
 {
 public:
-	raw_file_rdwr_stream_t(const std::string &filename, bool writing);
+	/// When writing, all data written to the file is also written to @p tee (not owned).
+	/// Errors of @p tee do not affect this stream.
+	raw_file_rdwr_stream_t(const std::string &filename, bool writing, rdwr_stream_t *tee = NULL);
 
 	/// Takes ownership of an already open file.
 	/// @p writing must match the mode with which the file was opened.
@@ -33,6 +35,7 @@ public:
 
 private:
 	FILE *file;
+	rdwr_stream_t *tee;
 };
 
 
@@ -5,36 +5,310 @@
 
 #include "zlib_file_rdwr_stream.h"
 
+#include "../../dataobj/environment.h"
 #include "../../sys/simsys.h"
 #include "../../macros.h"
 #include "../../simdebug.h"
+#include "../../simmem.h"
 
 #include <cassert>
+#include <string.h>
 
+#ifdef MULTI_THREAD
+#include "../../utils/simthread.h"
+#endif
 
-zlib_file_rdwr_stream_t::zlib_file_rdwr_stream_t(const std::string &filename, bool writing, int compression) :
-	rdwr_stream_t(writing)
+
+#define SECTION_SIZE (1 << 20) // 1MiB uncompressed data per gzip member
+
+// gzip header: 10 bytes, XLEN, then our subfield 'S','X', LEN=8, compressed size, raw size
+#define SECTION_HEADER_SIZE (24)
+#define SECTION_EXTRA_LEN (12)
+
+
+static uint32 get_le32(const uint8 *p)
+{
+	return (uint32)p[0] | ((uint32)p[1] << 8) | ((uint32)p[2] << 16) | ((uint32)p[3] << 24);
+}
+
+
+static void set_le32(uint8 *p, uint32 v)
+{
+	p[0] = v & 0xFF;
+	p[1] = (v >> 8) & 0xFF;
+	p[2] = (v >> 16) & 0xFF;
+	p[3] = (v >> 24) & 0xFF;
+}
+
+
+/// @return true if this is the header of a member written by us
+static bool is_section_header(const uint8 *h)
+{
+	return h[0] == 0x1F  &&  h[1] == 0x8B  &&  h[2] == Z_DEFLATED  &&  (h[3] & 0x04)  &&
+		h[10] == SECTION_EXTRA_LEN  &&  h[11] == 0  &&  h[12] == 'S'  &&  h[13] == 'X'  &&  h[14] == 8  &&  h[15] == 0;
+}
+
+
+void *zlib_file_rdwr_stream_t::compress_section(void *ptr)
+{
+	section_t *s = (section_t *)ptr;
+	s->ok = false;
+
+	z_stream z;
+	MEMZERO(z);
+	if(  deflateInit2( &z, s->level, Z_DEFLATED, 15+16, 8, Z_DEFAULT_STRATEGY ) != Z_OK  ) {
+		return NULL;
+	}
+
+	// the sizes are filled in after compression
+	uint8 extra[SECTION_EXTRA_LEN] = { 'S', 'X', 8, 0 };
+	gz_header head;
+	MEMZERO(head);
+	head.os = 255;
+	head.extra = extra;
+	head.extra_len = SECTION_EXTRA_LEN;
+	deflateSetHeader( &z, &head );
+
+	const size_t bound = deflateBound( &z, s->raw_size ) + SECTION_HEADER_SIZE;
+	if(  s->capacity < bound  ) {
+		free( s->data );
+		s->data = MALLOCN( uint8, bound );
+		s->capacity = bound;
+	}
+
+	z.next_in = s->raw;
+	z.avail_in = s->raw_size;
+	z.next_out = s->data;
+	z.avail_out = (uInt)s->capacity;
+	const int ret = deflate( &z, Z_FINISH );
+	s->size = z.total_out;
+	deflateEnd( &z );
+
+	if(  ret == Z_STREAM_END  &&  s->size >= SECTION_HEADER_SIZE  &&  is_section_header(s->data)  ) {
+		set_le32( s->data + 16, (uint32)s->size );
+		set_le32( s->data + 20, s->raw_size );
+		s->ok = true;
+	}
+	return NULL;
+}
+
+
+void *zlib_file_rdwr_stream_t::decompress_section(void *ptr)
 {
+	section_t *s = (section_t *)ptr;
+	s->ok = false;
+
+	z_stream z;
+	MEMZERO(z);
+	if(  inflateInit2( &z, 15+16 ) != Z_OK  ) {
+		return NULL;
+	}
+	z.next_in = s->data;
+	z.avail_in = (uInt)s->size;
+	z.next_out = s->raw;
+	z.avail_out = s->raw_size;
+	const int ret = inflate( &z, Z_FINISH );
+	s->ok = ret == Z_STREAM_END  &&  z.total_out == s->raw_size;
+	inflateEnd( &z );
+	return NULL;
+}
+
+
+zlib_file_rdwr_stream_t::zlib_file_rdwr_stream_t(const std::string &filename, bool writing, int compression, rdwr_stream_t *tee) :
+	rdwr_stream_t(writing),
+	gzfp(NULL),
+	fp(NULL),
+	tee(tee),
+	sections(NULL),
+	max_sections(1),
+	used_sections(0),
+	raw_buf(NULL),
+	raw_fill(0),
+	read_section(0),
+	read_pos(0),
+	level(clamp( compression, 1, 9 ))
+{
+#ifdef MULTI_THREAD
+	max_sections = max( (uint32)1, (uint32)env_t::num_threads );
+#endif
+
 	if (is_writing()) {
-		compression = clamp( compression, 1, 9 );
-		char compr[4] = { 'w', 'b', (char)('0' + compression), 0 };
-		gzfp = dr_gzopen(filename.c_str(), compr);
+		fp = dr_fopen(filename.c_str(), "wb");
 	}
 	else {
-		gzfp = dr_gzopen(filename.c_str(), "rb");
+		// only sectioned files can be decompressed in parallel
+		fp = dr_fopen(filename.c_str(), "rb");
+		if(  fp  ) {
+			uint8 header[SECTION_HEADER_SIZE];
+			if(  fread( header, 1, SECTION_HEADER_SIZE, fp ) != SECTION_HEADER_SIZE  ||  !is_section_header(header)  ) {
+				fclose( fp );
+				fp = NULL;
+			}
+			else {
+				rewind( fp );
+			}
+		}
+		if(  fp == NULL  ) {
+			gzfp = dr_gzopen(filename.c_str(), "rb");
+			if(  gzfp == NULL  ) {
+				status = STATUS_ERR_NOT_EXISTING;
+				return;
+			}
+			gzbuffer(gzfp, 65536);
+			status = STATUS_OK;
+			return;
+		}
+	}
+
+	if(  fp == NULL  ) {
+		status = writing ? STATUS_ERR_FULL : STATUS_ERR_NOT_EXISTING;
+		return;
+	}
+
+	raw_buf = MALLOCN( uint8, max_sections * SECTION_SIZE );
+	sections = MALLOCN( section_t, max_sections );
+	for(  uint32 i = 0;  i < max_sections;  i++  ) {
+		sections[i].data = NULL;
+		sections[i].size = 0;
+		sections[i].capacity = 0;
+		sections[i].raw = raw_buf + i * SECTION_SIZE;
+		sections[i].raw_size = 0;
+		sections[i].level = level;
+		sections[i].ok = false;
 	}
-	gzbuffer(gzfp, 65536);
 	status = STATUS_OK;
 }
 
 
 zlib_file_rdwr_stream_t::~zlib_file_rdwr_stream_t()
 {
-	if (is_writing()) {
-		gzflush(gzfp, Z_FINISH);
+	if(  gzfp  ) {
+		gzclose(gzfp);
+	}
+	if(  fp  ) {
+		if(  is_writing()  &&  status == STATUS_OK  ) {
+			// an empty file is still an empty gzip member
+			if(  raw_fill > 0  ||  ftell(fp) == 0  ) {
+				flush_sections();
+			}
+		}
+		fclose( fp );
 	}
+	if(  sections  ) {
+		for(  uint32 i = 0;  i < max_sections;  i++  ) {
+			free( sections[i].data );
+		}
+		free( sections );
+	}
+	free( raw_buf );
+}
 
-	gzclose(gzfp);
+
+void zlib_file_rdwr_stream_t::process_sections(void *(*func)(void *))
+{
+#ifdef MULTI_THREAD
+	if(  used_sections > 1  ) {
+		pthread_t *threads = MALLOCN( pthread_t, used_sections );
+		bool *started = MALLOCN( bool, used_sections );
+		for(  uint32 i = 1;  i < used_sections;  i++  ) {
+			started[i] = pthread_create( &threads[i], NULL, func, &sections[i] ) == 0;
+		}
+		func( &sections[0] );
+		for(  uint32 i = 1;  i < used_sections;  i++  ) {
+			if(  started[i]  ) {
+				pthread_join( threads[i], NULL );
+			}
+			else {
+				func( &sections[i] );
+			}
+		}
+		free( started );
+		free( threads );
+		return;
+	}
+#endif
+	for(  uint32 i = 0;  i < used_sections;  i++  ) {
+		func( &sections[i] );
+	}
+}
+
+
+bool zlib_file_rdwr_stream_t::flush_sections()
+{
+	used_sections = 0;
+	for(  size_t start = 0;  start < raw_fill  ||  used_sections == 0;  start += SECTION_SIZE  ) {
+		sections[used_sections].raw_size = (uint32)min( (size_t)SECTION_SIZE, raw_fill - start );
+		used_sections++;
+	}
+	process_sections( &compress_section );
+
+	for(  uint32 i = 0;  i < used_sections;  i++  ) {
+		if(  !sections[i].ok  ) {
+			dbg->error( "zlib_file_rdwr_stream_t::flush_sections", "Error during compression" );
+			status = STATUS_ERR_CORRUPT;
+			return false;
+		}
+		if(  fwrite( sections[i].data, 1, sections[i].size, fp ) != sections[i].size  ) {
+			status = STATUS_ERR_FULL;
+			return false;
+		}
+		if(  tee  &&  tee->get_status() == STATUS_OK  ) {
+			tee->write( sections[i].data, sections[i].size );
+		}
+	}
+	raw_fill = 0;
+	return true;
+}
+
+
+bool zlib_file_rdwr_stream_t::fill_sections()
+{
+	used_sections = 0;
+	read_section = 0;
+	read_pos = 0;
+
+	while(  used_sections < max_sections  ) {
+		section_t &s = sections[used_sections];
+		uint8 header[SECTION_HEADER_SIZE];
+		const size_t got = fread( header, 1, SECTION_HEADER_SIZE, fp );
+		if(  got == 0  &&  feof(fp)  ) {
+			break;
+		}
+		if(  got != SECTION_HEADER_SIZE  ||  !is_section_header(header)  ) {
+			status = STATUS_ERR_CORRUPT;
+			return false;
+		}
+		const uint32 size = get_le32( header + 16 );
+		const uint32 raw_size = get_le32( header + 20 );
+		if(  size < SECTION_HEADER_SIZE  ||  raw_size > SECTION_SIZE  ) {
+			status = STATUS_ERR_CORRUPT;
+			return false;
+		}
+		if(  s.capacity < size  ) {
+			free( s.data );
+			s.data = MALLOCN( uint8, size );
+			s.capacity = size;
+		}
+		memcpy( s.data, header, SECTION_HEADER_SIZE );
+		if(  fread( s.data + SECTION_HEADER_SIZE, 1, size - SECTION_HEADER_SIZE, fp ) != size - SECTION_HEADER_SIZE  ) {
+			status = STATUS_ERR_CORRUPT;
+			return false;
+		}
+		s.size = size;
+		s.raw_size = raw_size;
+		used_sections++;
+	}
+
+	process_sections( &decompress_section );
+
+	for(  uint32 i = 0;  i < used_sections;  i++  ) {
+		if(  !sections[i].ok  ) {
+			dbg->error( "zlib_file_rdwr_stream_t::fill_sections", "Error during decompression" );
+			status = STATUS_ERR_CORRUPT;
+			return false;
+		}
+	}
+	return used_sections > 0;
 }
 
 
@@ -42,6 +316,29 @@ size_t zlib_file_rdwr_stream_t::read(void *buf, size_t len)
 {
 	assert(!is_writing());
 
+	if(  fp  ) {
+		size_t bytes_read = 0;
+		while(  bytes_read < len  ) {
+			while(  read_section < used_sections  &&  read_pos == sections[read_section].raw_size  ) {
+				read_section++;
+				read_pos = 0;
+			}
+			if(  read_section >= used_sections  &&  !fill_sections()  ) {
+				if(  status == STATUS_OK  ) {
+					status = STATUS_EOF;
+				}
+				return bytes_read;
+			}
+			const section_t &s = sections[read_section];
+			const size_t n = min( len - bytes_read, s.raw_size - read_pos );
+			memcpy( (uint8 *)buf + bytes_read, s.raw + read_pos, n );
+			read_pos += n;
+			bytes_read += n;
+		}
+		status = STATUS_OK;
+		return bytes_read;
+	}
+
 	const int bytes_read = gzread(gzfp, buf, len);
 
 	if (bytes_read >= 0 && (size_t)bytes_read == len) {
@@ -70,16 +367,19 @@ size_t zlib_file_rdwr_stream_t::read(void *buf, size_t len)
 size_t zlib_file_rdwr_stream_t::write(const void *buf, size_t len)
 {
 	assert(is_writing());
-	const int bytes_written = gzwrite(gzfp, const_cast<void *>(buf), len);
 
-	if (bytes_written == 0) {
-		status = STATUS_ERR_FULL;
-		return 0;
-	}
-	else {
-		status = STATUS_OK;
-		return bytes_written;
+	const size_t buf_size = (size_t)max_sections * SECTION_SIZE;
+	size_t written = 0;
+	while(  written < len  ) {
+		const size_t n = min( len - written, buf_size - raw_fill );
+		memcpy( raw_buf + raw_fill, (const uint8 *)buf + written, n );
+		raw_fill += n;
+		written += n;
+		if(  raw_fill == buf_size  &&  !flush_sections()  ) {
+			return 0;
+		}
 	}
-}
-
 
+	status = STATUS_OK;
+	return written;
+}
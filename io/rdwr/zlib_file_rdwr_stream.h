@@ -9,14 +9,22 @@
 
 #include "rdwr_stream.h"
 
+#include <cstdio>
 #include <zlib.h>
 
 
 /// Reads/writes data from/to a zlib/gzip (deflate) compressed file.
+///
+/// Data is written as a series of independent gzip members (sections) of at most
+/// SECTION_SIZE bytes each. The gzip header of each member carries its compressed
+/// and uncompressed size in an extra field, so several sections can be
+/// compressed and decompressed in parallel. The result is still an ordinary
+/// gzip file; files without these extra fields are read through gzread.
 class zlib_file_rdwr_stream_t : public rdwr_stream_t
 {
 public:
-	zlib_file_rdwr_stream_t(const std::string &filename, bool writing, int compression);
+	/// When writing, the compressed data is also written to @p tee (not owned).
+	zlib_file_rdwr_stream_t(const std::string &filename, bool writing, int compression, rdwr_stream_t *tee = NULL);
 	~zlib_file_rdwr_stream_t();
 
 public:
@@ -27,7 +35,46 @@ public:
 	size_t write(const void *buf, size_t len) OVERRIDE;
 
 private:
+	/// one gzip member, compressed or decompressed by one thread
+	struct section_t
+	{
+		uint8 *data;      ///< complete gzip member
+		size_t size;
+		size_t capacity;
+		uint8 *raw;       ///< uncompressed data
+		uint32 raw_size;
+		int level;
+		bool ok;
+	};
+
+	static void *compress_section(void *section);
+	static void *decompress_section(void *section);
+
+	/// compress the filled sections and write them
+	bool flush_sections();
+
+	/// read and decompress the next sections
+	bool fill_sections();
+
+	/// run compress or decompress on all used sections
+	void process_sections(void *(*func)(void *));
+
+	/// legacy gzip file, read by zlib
 	gzFile gzfp;
+
+	/// sectioned file
+	FILE *fp;
+	rdwr_stream_t *tee;
+
+	section_t *sections;
+	uint32 max_sections;
+	uint32 used_sections;
+
+	uint8 *raw_buf;
+	size_t raw_fill; ///< (writing) bytes in raw_buf
+	uint32 read_section; ///< (reading) section currently read from
+	size_t read_pos;     ///< (reading) position in this section
+	int level;
 };
 
 
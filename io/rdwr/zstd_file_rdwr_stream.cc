@@ -13,8 +13,8 @@
 #define ZSTD_FILE_BUF_SIZE (1 << 20) // 1MiB
 
 
-zstd_file_rdwr_stream_t::zstd_file_rdwr_stream_t(const std::string &filename, bool writing, int compression_level) :
-	raw_file_rdwr_stream_t(filename, writing),
+zstd_file_rdwr_stream_t::zstd_file_rdwr_stream_t(const std::string &filename, bool writing, int compression_level, rdwr_stream_t *tee) :
+	raw_file_rdwr_stream_t(filename, writing, tee),
 	zbuff(NULL)
 {
 	if (status != STATUS_OK) {
@@ -21,7 +21,7 @@
 class zstd_file_rdwr_stream_t : public raw_file_rdwr_stream_t
 {
 public:
-	zstd_file_rdwr_stream_t(const std::string &filename, bool writing, int compression);
+	zstd_file_rdwr_stream_t(const std::string &filename, bool writing, int compression, rdwr_stream_t *tee = NULL);
 	~zstd_file_rdwr_stream_t();
 
 public:
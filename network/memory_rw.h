@@ -57,6 +57,9 @@ public:
 
 	void rdwr_str(plainstring& s);
 
+	/// reads/writes @p len bytes as they are
+	void rdwr_bytes(void *data, uint32 len) { rdwr(data, len); }
+
 	/**
 	 * appends the contents of the other buffer from [0 .. index-1]
 	 * (only if saving)
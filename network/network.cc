@@ -26,12 +26,16 @@
 #include "../dataobj/environment.h"
 #endif
 
-#ifdef NETTOOL
-#include "../tpl/vector_tpl.h"
-#endif
-
 #include "../utils/simstring.h"
 #include "../tpl/slist_tpl.h"
+#include "../tpl/vector_tpl.h"
+
+#ifdef MULTI_THREAD
+#include "../utils/simthread.h"
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+#endif
 
 static bool network_active = false;
 uint16 network_server_port = 0;
@@ -39,6 +43,128 @@ uint16 network_server_port = 0;
 // list of received commands
 static slist_tpl<network_command_t *> received_command_queue;
 
+#ifndef NETTOOL
+// server: packets of the commands for all clients, sent by network_flush_broadcasts()
+static vector_tpl<packet_t *> pending_broadcasts;
+#endif
+
+#ifdef MULTI_THREAD
+// server: sends to the playing clients, so a slow client does not stall the main thread
+static pthread_t send_thread;
+static bool send_thread_running = false;
+static bool send_thread_stop = false;
+static bool send_thread_wakeup = false;
+static pthread_mutex_t send_thread_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t send_thread_cond = PTHREAD_COND_INITIALIZER;
+
+// how long the send thread waits for the sockets of slow clients before looking for new packets again
+#define SEND_THREAD_POLL_MS (10)
+
+
+/**
+ * waits until one of the sockets can be written to or the timeout elapses
+ */
+static void wait_writable(const vector_tpl<SOCKET> &sockets, int timeout_ms)
+{
+#ifdef __linux__
+	static int epoll_fd = -1;
+	if(  epoll_fd == -1  ) {
+		epoll_fd = epoll_create1(0);
+	}
+	if(  epoll_fd != -1  ) {
+		FOR(vector_tpl<SOCKET>, const s, sockets) {
+			struct epoll_event ev;
+			ev.events = EPOLLOUT;
+			ev.data.fd = s;
+			epoll_ctl(epoll_fd, EPOLL_CTL_ADD, s, &ev);
+		}
+		struct epoll_event events[16];
+		epoll_wait(epoll_fd, events, lengthof(events), timeout_ms);
+		FOR(vector_tpl<SOCKET>, const s, sockets) {
+			epoll_ctl(epoll_fd, EPOLL_CTL_DEL, s, NULL);
+		}
+		return;
+	}
+#endif
+	fd_set fds;
+	FD_ZERO(&fds);
+	FOR(vector_tpl<SOCKET>, const s, sockets) {
+		FD_SET(s, &fds);
+	}
+	struct timeval tv;
+	tv.tv_sec = 0;
+	tv.tv_usec = timeout_ms * 1000ul;
+	select(FD_SETSIZE, NULL, &fds, NULL, &tv);
+}
+
+
+static void *network_send_thread(void *)
+{
+	vector_tpl<SOCKET> waiting;
+	while(  true  ) {
+		// sleep until the main thread has queued something
+		pthread_mutex_lock(&send_thread_mutex);
+		while(  !send_thread_wakeup  &&  !send_thread_stop  ) {
+			pthread_cond_wait(&send_thread_cond, &send_thread_mutex);
+		}
+		send_thread_wakeup = false;
+		const bool stop = send_thread_stop;
+		pthread_mutex_unlock(&send_thread_mutex);
+		if(  stop  ) {
+			break;
+		}
+
+		// send until all queues are empty; the sockets of slow clients are waited for without holding the lock
+		do {
+			waiting.clear();
+			socket_list_t::lock();
+			for(  uint32 i = socket_list_t::get_server_sockets();  i < socket_list_t::get_count();  i++  ) {
+				socket_info_t &info = socket_list_t::get_client(i);
+				if(  info.state == socket_info_t::playing  &&  info.socket != INVALID_SOCKET  &&  !info.send_failed  &&  info.has_pending_sends()  ) {
+					if(  !info.process_send_queue()  ) {
+						info.send_failed = true;
+					}
+					else if(  info.has_pending_sends()  ) {
+						waiting.append(info.socket);
+					}
+				}
+			}
+			socket_list_t::unlock();
+			if(  !waiting.empty()  ) {
+				wait_writable(waiting, SEND_THREAD_POLL_MS);
+			}
+		} while(  !waiting.empty()  &&  !send_thread_stop  );
+	}
+	return NULL;
+}
+
+
+static void network_start_send_thread()
+{
+	if(  !send_thread_running  ) {
+		send_thread_stop = false;
+		send_thread_wakeup = false;
+		send_thread_running = pthread_create(&send_thread, NULL, network_send_thread, NULL) == 0;
+		if(  !send_thread_running  ) {
+			dbg->warning("network_start_send_thread()", "cannot start send thread, sending from the main thread");
+		}
+	}
+}
+
+
+static void network_stop_send_thread()
+{
+	if(  send_thread_running  ) {
+		pthread_mutex_lock(&send_thread_mutex);
+		send_thread_stop = true;
+		pthread_cond_signal(&send_thread_cond);
+		pthread_mutex_unlock(&send_thread_mutex);
+		pthread_join(send_thread, NULL);
+		send_thread_running = false;
+	}
+}
+#endif
+
 // blacklist
 address_list_t blacklist;
 
@@ -461,6 +587,9 @@ bool network_init_server(int port)
 	client_id = 0;
 
 	network_reset_server();
+#ifdef MULTI_THREAD
+	network_start_send_thread();
+#endif
 	return true;
 }
 
@@ -472,6 +601,10 @@ void network_set_socket_nodelay(SOCKET sock)
 	// force this for dedicated servers
 	int b = 1;
 	setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&b, sizeof(b));
+#ifdef SO_NOSIGPIPE
+	// no MSG_NOSIGNAL on all systems
+	setsockopt(sock, SOL_SOCKET, SO_NOSIGPIPE, (const char*)&b, sizeof(b));
+#endif
 #else
 	#warning TCP_NODELAY not defined.Expect multiplayer problems.
 		(void)sock;
@@ -550,6 +683,14 @@ network_command_t* network_check_activity(karte_t *, int timeout)
 		if (sender != INVALID_SOCKET  &&  socket_list_t::has_client(sender)) {
 			uint32 client_id = socket_list_t::get_client_id(sender);
 			network_command_t *nwc = socket_list_t::get_client(client_id).receive_nwc();
+#ifndef NETTOOL
+			if (nwc  &&  nwc->get_id() == NWC_BATCH) {
+				// queue the commands of the batch in their order
+				static_cast<nwc_batch_t *>(nwc)->unpack(received_command_queue);
+				delete nwc;
+				nwc = NULL;
+			}
+#endif
 			if (nwc) {
 				received_command_queue.append(nwc);
 				dbg->message( "network_check_activity()", "received cmd %s (id %d) from socket[%d]", nwc->get_name(), nwc->get_id(), sender );
@@ -563,6 +704,26 @@ network_command_t* network_check_activity(karte_t *, int timeout)
 
 void network_process_send_queues(int timeout)
 {
+	network_flush_broadcasts();
+
+#ifdef MULTI_THREAD
+	if(  send_thread_running  ) {
+		// the send thread serves the playing clients, here only the others are served
+		socket_list_t::lock();
+		for(  uint32 i = socket_list_t::get_server_sockets();  i < socket_list_t::get_count();  i++  ) {
+			if(  socket_list_t::get_client(i).send_failed  ) {
+				socket_list_t::remove_client(socket_list_t::get_client(i).socket);
+			}
+		}
+		socket_list_t::unlock();
+
+		pthread_mutex_lock(&send_thread_mutex);
+		send_thread_wakeup = true;
+		pthread_cond_signal(&send_thread_cond);
+		pthread_mutex_unlock(&send_thread_mutex);
+	}
+#endif
+
 	fd_set fds;
 	FD_ZERO(&fds);
 
@@ -586,9 +747,17 @@ void network_process_send_queues(int timeout)
 		SOCKET sock = iter_c.get_current();
 
 		if (sock != INVALID_SOCKET  &&  socket_list_t::has_client(sock)) {
-			uint32 client_id = socket_list_t::get_client_id(sock);
-			socket_list_t::get_client(client_id).process_send_queue();
-			// errors are caught and treated in socket_info_t::process_send_queue
+			socket_info_t &info = socket_list_t::get_client(socket_list_t::get_client_id(sock));
+#ifdef MULTI_THREAD
+			if (send_thread_running  &&  info.state == socket_info_t::playing) {
+				action--;
+				continue;
+			}
+#endif
+			if (!info.process_send_queue()) {
+				// close this client, clear the send_queue
+				socket_list_t::remove_client(sock);
+			}
 		}
 		action--;
 	}
@@ -624,13 +793,50 @@ bool network_check_server_connection()
 }
 
 
+void network_flush_broadcasts()
+{
+#ifndef NETTOOL
+	// all commands queued in one step go to a client in as few packets as possible
+	uint32 i = 0;
+	while (i < pending_broadcasts.get_count()) {
+		nwc_batch_t batch;
+		uint32 n = i;
+		while (n < pending_broadcasts.get_count()  &&  batch.append(*pending_broadcasts[n])) {
+			n++;
+		}
+		if (n - i > 1) {
+			batch.prepare_to_send();
+			socket_list_t::send_all(batch.get_packet(), true);
+		}
+		else {
+			// alone or too large for a batch
+			socket_list_t::send_all(pending_broadcasts[i], true);
+			n = i + 1;
+		}
+		i = n;
+	}
+	clear_ptr_vector(pending_broadcasts);
+#endif
+}
+
+
 // send data to all PLAYING clients
 // nwc is invalid after the call
 void network_send_all(network_command_t* nwc, bool exclude_us)
 {
 	if (nwc) {
 		nwc->prepare_to_send();
+#ifndef NETTOOL
+		if (network_server_port) {
+			// sent together with the other commands of this step
+			pending_broadcasts.append(nwc->copy_packet());
+		}
+		else {
+			socket_list_t::send_all(nwc, true);
+		}
+#else
 		socket_list_t::send_all(nwc, true);
+#endif
 		if (!exclude_us  &&  network_server_port) {
 			// I am the server
 			nwc->get_packet()->sent_by_server();
@@ -673,13 +879,25 @@ bool network_send_data(SOCKET dest, const char *buf, const uint16 size, uint16 &
 {
 	count = 0;
 
-#if USE_WINSOCK == 0
+#if USE_WINSOCK == 0  &&  !defined(MSG_NOSIGNAL)
 	// ignore SIGPIPE sent by send() function.
 	signal(SIGPIPE, SIG_IGN);
 #endif
 
+	int flags = 0;
+#ifdef MSG_NOSIGNAL
+	// the send thread and the main thread must not change the signal handler under each other
+	flags |= MSG_NOSIGNAL;
+#endif
+#ifdef MSG_DONTWAIT
+	if (timeout_ms <= 0) {
+		// the socket may be writable, but not for the whole packet
+		flags |= MSG_DONTWAIT;
+	}
+#endif
+
 	while (count < size) {
-		int sent = send(dest, buf + count, size - count, 0);
+		int sent = send(dest, buf + count, size - count, flags);
 		if (sent == -1) {
 			int err = GET_LAST_ERROR();
 			if (err != EWOULDBLOCK) {
@@ -715,7 +933,7 @@ bool network_send_data(SOCKET dest, const char *buf, const uint16 size, uint16 &
 		DBG_DEBUG4("network_send_data", "sent %d bytes to socket[%d]; size=%d, left=%d", count, dest, size, size - count);
 	}
 
-#if USE_WINSOCK == 0
+#if USE_WINSOCK == 0  &&  !defined(MSG_NOSIGNAL)
 	signal(SIGPIPE, SIG_DFL);
 #endif
 
@@ -815,6 +1033,9 @@ void network_reset_server()
 */
 void network_core_shutdown()
 {
+#ifdef MULTI_THREAD
+	network_stop_send_thread();
+#endif
 	clear_command_queue();
 
 	socket_list_t::reset();
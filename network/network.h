@@ -64,7 +64,11 @@ typedef int SOCKET;
 #include "../simtypes.h"
 #include "../utils/cbuffer_t.h"
 // version of network protocol code
-#define NETWORK_VERSION (1)
+// 2: commands to the clients are sent in batches (NWC_BATCH)
+// 3: the game is sent to a joining client in chunks while it is saved (nwc_game_t::CHUNKED)
+// 4: checklists carry the hashes of the parts of the game state (checklist_t::subsystem_hash)
+// 5: heavy mode 1 hashes one part per sync step, the whole game state is one of them (CHK_GAMESTATE)
+#define NETWORK_VERSION (5)
 
 class network_command_t;
 class gameinfo_t;
@@ -121,8 +125,12 @@ bool network_send_data( SOCKET dest, const char *buf, const uint16 size, uint16
 */
 bool network_receive_data(SOCKET sender, void *dest, const uint16 len, uint16 &received, const int timeout_ms);
 
+// server: sends the pending commands for all clients, then sends from the queues
 void network_process_send_queues(int timeout);
 
+// server: sends the commands given to network_send_all() since the last call, batched
+void network_flush_broadcasts();
+
 // true, if I can write on the server connection
 bool network_check_server_connection();
 
@@ -72,7 +72,10 @@ void network_command_t::prepare_to_send()
 bool network_command_t::send(SOCKET s)
 {
 	prepare_to_send();
+	// not while the send thread sends to s
+	socket_list_t::lock();
 	packet->send(s, true);
+	socket_list_t::unlock();
 	bool ok = packet->is_ready();
 	if (!ok) {
 		dbg->warning("network_command_t::send", "Sending %s to [%d] failed", get_name(), s);
@@ -176,6 +179,7 @@ const char *network_command_t::id_to_string(uint16 id)
 	CASE_TO_STRING(NWC_SCENARIO_RULES);
 	CASE_TO_STRING(NWC_STEP);
 	CASE_TO_STRING(NWC_ROUTESEARCH);
+	CASE_TO_STRING(NWC_BATCH);
 	}
 
 	return "<unknown network command>";
@@ -39,6 +39,7 @@ enum {
 	NWC_SCENARIO_RULES,
 	NWC_STEP,
 	NWC_ROUTESEARCH,
+	NWC_BATCH,
 	NWC_COUNT
 };
 
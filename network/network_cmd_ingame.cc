@@ -27,6 +27,8 @@
 #include "../utils/csv.h"
 #include "../display/viewport.h"
 
+#include <zlib.h>
+
 
 network_command_t* network_command_t::read_from_packet(packet_t *p)
 {
@@ -56,6 +58,7 @@ network_command_t* network_command_t::read_from_packet(packet_t *p)
 		                      nwc = new nwc_scenario_rules_t(); break;
 		case NWC_ROUTESEARCH: nwc = new nwc_routesearch_t(); break;
 		case NWC_STEP:        nwc = new nwc_step_t(); break;
+		case NWC_BATCH:       nwc = new nwc_batch_t(); break;
 		default:
 			dbg->warning("network_command_t::read_from_socket", "received unknown packet id %d", p->get_id());
 	}
@@ -442,10 +445,22 @@ bool nwc_join_t::execute(karte_t *welt)
 		if(  nwj.send( packet->get_sender() )  ) {
 			if(  nwj.answer==1  ) {
 				// now send sync command
-				const uint32 new_map_counter = welt->generate_new_map_counter();
+				// an unchanged map counter tells the clients that only the joining client receives the game
+				uint32 new_map_counter = welt->get_map_counter();
+				if(  !env_t::server_snapshot_join  ) {
+					new_map_counter = welt->generate_new_map_counter();
+					if(  new_map_counter == welt->get_map_counter()  ) {
+						new_map_counter++;
+					}
+				}
 				// since network_send_all() does not include non-playing clients -> send sync command separately to the joining client
 				nwc_sync_t nw_sync(welt->get_sync_steps() + 1, welt->get_map_counter(), nwj.client_id, new_map_counter);
 				nw_sync.rdwr();
+				if(  env_t::server_snapshot_join  ) {
+					// commands from now on are not part of the snapshot, the joining client gets them after the game;
+					// this must start before NWC_SYNC, as the client drops everything it receives between NWC_SYNC and the game
+					socket_list_t::get_client(nwj.client_id).set_hold_back(true);
+				}
 				if(  nw_sync.send( packet->get_sender() )  ) {
 					// now send sync command to the server and the remaining clients
 					nwc_sync_t *nws = new nwc_sync_t(welt->get_sync_steps() + 1, welt->get_map_counter(), nwj.client_id, new_map_counter);
@@ -458,6 +473,7 @@ bool nwc_join_t::execute(karte_t *welt)
 					}
 				}
 				else {
+					socket_list_t::get_client(nwj.client_id).set_hold_back(false);
 					dbg->warning("nwc_join_t::execute", "send of NWC_SYNC to the joining client failed");
 				}
 			}
@@ -712,6 +728,13 @@ void nwc_sync_t::do_command(karte_t *welt)
 			}
 		}
 	}
+	// unchanged map counter: only the joining client receives a snapshot, everybody else keeps running
+	const bool snapshot = new_map_counter == welt->get_map_counter();
+	if(  snapshot  &&  !env_t::server  ) {
+		// but continues from the same state as the joining client, like the server below
+		welt->reset_unsaved_state();
+		return;
+	}
 	// transfer game, all clients need to sync (save, reload, and pause)
 	// now save and send
 	dr_chdir( env_t::user_dir );
@@ -739,40 +762,68 @@ void nwc_sync_t::do_command(karte_t *welt)
 	}
 	else {
 		char fn[256];
-		// first save password hashes
-		sprintf( fn, "server%d-pwdhash.sve", env_t::server );
-		loadsave_t file;
-		if(file.wr_open(fn, loadsave_t::zipped, 1, "hashes", SAVEGAME_VER_NR, EXTENDED_VER_NR, EXTENDED_REVISION_NR) == loadsave_t::FILE_STATUS_OK) {
-			welt->rdwr_player_password_hashes( &file );
-			file.close();
-		}
-		else
-		{
-			dbg->warning("nwc_sync_t::do_command", "Could not save %s. Passwords may be reset on loading game.", fn);
+		if(  !snapshot  ) {
+			// first save password hashes
+			sprintf( fn, "server%d-pwdhash.sve", env_t::server );
+			loadsave_t file;
+			if(file.wr_open(fn, loadsave_t::zipped, 1, "hashes", SAVEGAME_VER_NR, EXTENDED_VER_NR, EXTENDED_REVISION_NR) == loadsave_t::FILE_STATUS_OK) {
+				welt->rdwr_player_password_hashes( &file );
+				file.close();
+			}
+			else
+			{
+				dbg->warning("nwc_sync_t::do_command", "Could not save %s. Passwords may be reset on loading game.", fn);
+			}
 		}
 
 		// remove passwords before transfer on the server and set default client mask
-		// they will be restored in karte_t::load
+		// they will be restored in karte_t::load, or below for a snapshot
 		uint16 unlocked_players = 0;
+		pwd_hash_t pwd_hashes[PLAYER_UNOWNED];
 		for(  int i=0;  i<PLAYER_UNOWNED; i++  ) {
 			player_t *player = welt->get_player(i);
 			if(  player==NULL  ||  player->access_password_hash().empty()  ) {
 				unlocked_players |= (1<<i);
 			}
 			else {
+				pwd_hashes[i] = player->access_password_hash();
 				player->access_password_hash().clear();
 			}
 		}
 
-		// save game
+		// save game and send it to the client while saving
+		// this sends nwc_game_t
 		sprintf( fn, "server%d-network.sve", env_t::server );
 		bool old_restore_UI = env_t::restore_UI;
 		env_t::restore_UI = true;
-		welt->save( fn, false, SERVER_SAVEGAME_VER_NR, EXTENDED_VER_NR, EXTENDED_REVISION_NR, false );
+		const char *err = NULL;
+		SOCKET game_sock = socket_list_t::get_socket(client_id);
+		nwc_game_t nwgame( nwc_game_t::CHUNKED );
+		if(  game_sock != INVALID_SOCKET  &&  nwgame.send(game_sock)  ) {
+			network_send_stream_t send_stream( game_sock );
+			welt->save( fn, false, SERVER_SAVEGAME_VER_NR, EXTENDED_VER_NR, EXTENDED_REVISION_NR, false, &send_stream );
+			if(  !send_stream.finish()  ) {
+				socket_list_t::remove_client( game_sock );
+				err = "Client closed connection during transfer";
+			}
+		}
+		else {
+			welt->save( fn, false, SERVER_SAVEGAME_VER_NR, EXTENDED_VER_NR, EXTENDED_REVISION_NR, false );
+			err = "Client closed connection during transfer";
+		}
+
+		if(  snapshot  ) {
+			for(  int i=0;  i<PLAYER_UNOWNED; i++  ) {
+				if(  player_t *player = welt->get_player(i)  ) {
+					if(  !pwd_hashes[i].empty()  ) {
+						player->access_password_hash() = pwd_hashes[i];
+					}
+				}
+			}
+			// continue from the same state as the client which loads the snapshot
+			welt->reset_unsaved_state();
+		}
 
-		// ok, now sending game
-		// this sends nwc_game_t
-		const char *err = network_send_file( client_id, fn );
 		if (err) {
 			dbg->warning("nwc_sync_t::do_command","send game failed with: %s", err);
 		}
@@ -786,14 +837,18 @@ void nwc_sync_t::do_command(karte_t *welt)
 		}
 
 		uint32 old_sync_steps = welt->get_sync_steps();
-		welt->load( fn );
+		if(  !snapshot  ) {
+			welt->load( fn );
+		}
 		env_t::restore_UI = old_restore_UI;
 
-		// restore steps
-		welt->network_game_set_pause( false, old_sync_steps);
+		if(  !snapshot  ) {
+			// restore steps
+			welt->network_game_set_pause( false, old_sync_steps);
 
-		// apply new map counter
-		welt->set_map_counter(new_map_counter);
+			// apply new map counter
+			welt->set_map_counter(new_map_counter);
+		}
 
 		// unpause the client that received the game
 		// we do not want to wait for him (maybe loading failed due to pakset-errors)
@@ -820,6 +875,10 @@ void nwc_sync_t::do_command(karte_t *welt)
 				dbg->warning( "nwc_sync_t::do_command", "send of NWC_READY failed" );
 			}
 		}
+		if(  socket_list_t::is_valid_client_id(client_id)  ) {
+			// the client catches up with the commands issued since the snapshot
+			socket_list_t::get_client(client_id).set_hold_back(false);
+		}
 		nwc_join_t::pending_join_client = INVALID_SOCKET;
 	}
 	// restore screen coordinates & offsets
@@ -1514,7 +1573,11 @@ bool nwc_service_t::execute(karte_t *welt)
 		}
 
 		case SRVC_FORCE_SYNC: {
-			const uint32 new_map_counter = welt->generate_new_map_counter();
+			// an unchanged map counter would be taken for a snapshot join
+			uint32 new_map_counter = welt->generate_new_map_counter();
+			if(  new_map_counter == welt->get_map_counter()  ) {
+				new_map_counter++;
+			}
 			nwc_sync_t *nw_sync = new nwc_sync_t(welt->get_sync_steps() + 1, welt->get_map_counter(), -1, new_map_counter);
 
 			if (welt->is_paused()) {
@@ -1611,3 +1674,85 @@ bool nwc_service_t::execute(karte_t *welt)
 	}
 	return true; // to delete
 }
+
+
+void nwc_batch_t::rdwr()
+{
+	network_command_t::rdwr();
+	packet->rdwr_short(count);
+	packet->rdwr_short(raw_size);
+
+	// compressed size, zero if not compressed
+	uint8 compressed[MAX_BATCH_LEN];
+	uint16 size = 0;
+	if (packet->is_saving()) {
+		uLongf len = sizeof(compressed);
+		// a few steps and checks are too short to gain anything
+		if (raw_size >= 128  &&  compress2(compressed, &len, raw, raw_size, Z_BEST_SPEED) == Z_OK  &&  len < raw_size) {
+			size = (uint16)len;
+		}
+	}
+	packet->rdwr_short(size);
+
+	if (raw_size > MAX_BATCH_LEN  ||  size > MAX_BATCH_LEN) {
+		packet->failed();
+		return;
+	}
+	if (size == 0) {
+		packet->rdwr_bytes(raw, raw_size);
+	}
+	else {
+		packet->rdwr_bytes(compressed, size);
+		if (packet->is_loading()) {
+			uLongf len = sizeof(raw);
+			if (packet->has_failed()  ||  uncompress(raw, &len, compressed, size) != Z_OK  ||  len != raw_size) {
+				dbg->warning("nwc_batch_t::rdwr", "corrupt batch of %d commands", count);
+				packet->failed();
+			}
+		}
+	}
+}
+
+
+bool nwc_batch_t::append(const packet_t &p)
+{
+	const uint16 len = p.get_data_size();
+	if (raw_size + 4 + len > MAX_BATCH_LEN) {
+		return false;
+	}
+	uint8 *dest = raw + raw_size;
+	dest[0] = p.get_id() & 0xFF;
+	dest[1] = p.get_id() >> 8;
+	dest[2] = len & 0xFF;
+	dest[3] = len >> 8;
+	memcpy(dest + 4, p.get_data(), len);
+	raw_size += 4 + len;
+	count++;
+	return true;
+}
+
+
+void nwc_batch_t::unpack(slist_tpl<network_command_t *> &list) const
+{
+	uint32 pos = 0;
+	for (uint16 i = 0; i < count; i++) {
+		if (pos + 4 > raw_size) {
+			break;
+		}
+		const uint16 cmd_id = raw[pos] | (raw[pos + 1] << 8);
+		const uint16 len    = raw[pos + 2] | (raw[pos + 3] << 8);
+		pos += 4;
+		if (pos + len > raw_size  ||  cmd_id == NWC_BATCH) {
+			break;
+		}
+		network_command_t *nwc = network_command_t::read_from_packet(new packet_t(packet->get_sender(), cmd_id, raw + pos, len));
+		if (nwc) {
+			list.append(nwc);
+			dbg->message("nwc_batch_t::unpack", "received cmd %s (id %d)", nwc->get_name(), nwc->get_id());
+		}
+		pos += len;
+	}
+	if (pos != raw_size) {
+		dbg->warning("nwc_batch_t::unpack", "corrupt batch of %d commands", count);
+	}
+}
@@ -8,6 +8,7 @@
 
 
 #include "network_cmd.h"
+#include "network_packet.h"
 #include "memory_rw.h"
 #include "../simworld.h"
 #include "../tpl/slist_tpl.h"
@@ -16,7 +17,6 @@
 #include "../dataobj/koord3d.h"
 
 class connection_info_t;
-class packet_t;
 class player_t;
 class tool_t;
 
@@ -167,6 +167,10 @@ private:
  */
 class nwc_game_t : public network_command_t {
 public:
+	/// length of a game sent in chunks while the server saves it
+	/// @see network_send_stream_t
+	enum { CHUNKED = 0xFFFFFFFFu };
+
 	nwc_game_t(uint32 len_=0) : network_command_t(NWC_GAME), len(len_) {}
 
 	void rdwr() OVERRIDE;
@@ -426,4 +430,39 @@ public:
 	bool execute(karte_t *) OVERRIDE { return true;}
 };
 
+
+// room for the batch header and client id in the packet
+#define MAX_BATCH_LEN (MAX_PACKET_LEN - 64)
+
+/**
+ * nwc_batch_t
+ * @from-server:
+ *      @data the packets of several commands broadcast to the clients during the same step,
+ *            zlib compressed if this makes them smaller
+ *      the client unpacks and queues them in order
+ */
+class nwc_batch_t : public network_command_t {
+public:
+	nwc_batch_t() : network_command_t(NWC_BATCH), count(0), raw_size(0) { }
+
+	void rdwr() OVERRIDE;
+
+	/**
+	 * adds the data of a command packet
+	 * @return false if it does not fit anymore
+	 */
+	bool append(const packet_t &p);
+
+	uint16 get_count() const { return count; }
+
+	/// creates the commands and appends them to @p list
+	void unpack(slist_tpl<network_command_t *> &list) const;
+
+private:
+	/// for each command: id, length, data
+	uint8 raw[MAX_BATCH_LEN];
+	uint16 count;
+	uint16 raw_size;
+};
+
 #endif
@@ -84,6 +84,63 @@ char const* network_receive_file( SOCKET const s, char const* const save_as, sin
 	return NULL;
 }
 
+
+static bool receive_all(SOCKET const s, char *dest, uint16 const len, sint32 const timeout)
+{
+	uint16 received = 0;
+	while(  received < len  ) {
+		uint16 count;
+		if(  !network_receive_data( s, dest + received, len - received, count, timeout )  ||  count == 0  ) {
+			return false;
+		}
+		received += count;
+	}
+	return true;
+}
+
+
+char const* network_receive_chunked_file( SOCKET const s, char const* const save_as, sint32 const timeout )
+{
+	dr_remove(save_as);
+
+	FILE* const f = dr_fopen(save_as, "wb");
+	if(  f == NULL  ) {
+		return "Could not open file";
+	}
+#ifndef NETTOOL // no display, no translator available
+	loadingscreen_t ls( translator::translate("Transferring game ..."), 0, true, true );
+#endif
+
+	char rbuf[65536];
+	uint32 length_read = 0;
+	while(  true  ) {
+		uint8 header[2];
+		if(  !receive_all( s, (char *)header, 2, timeout )  ) {
+			fclose(f);
+			return "Not enough bytes transferred";
+		}
+		const uint16 len = header[0] | (header[1] << 8);
+		if(  len == 0  ) {
+			// end marker
+			break;
+		}
+		if(  !receive_all( s, rbuf, len, timeout )  ) {
+			fclose(f);
+			return "Not enough bytes transferred";
+		}
+		if(  fwrite( rbuf, 1, len, f ) != len  ) {
+			// e.g. disk full: do not load a truncated game
+			fclose(f);
+			return "Could not write file";
+		}
+		length_read += len;
+	}
+	fclose(f);
+
+	DBG_MESSAGE("network_receive_chunked_file", "File size %u", length_read );
+	return NULL;
+}
+
 /*
  * Functions not needed by Nettool following below
  */
@@ -98,6 +155,9 @@ char const* network_receive_file( SOCKET const s, char const* const save_as, sin
 #include "../dataobj/environment.h"
 #include "../simworld.h"
 #include "../utils/simstring.h"
+#include "../macros.h"
+
+#include <assert.h>
 
 
 // connect to address (cp), receive gameinfo, close
@@ -242,11 +302,17 @@ const char *network_connect(const char *cp, karte_t *world)
 			err = "Protocol error (expected NWC_GAME)";
 			goto end;
 		}
-		int len = ((nwc_game_t*)nwc)->len;
+		const uint32 len = ((nwc_game_t*)nwc)->len;
 		// guaranteed individual file name ...
 		char filename[256];
 		sprintf( filename, "client%i-network.sve", network_get_client_id() );
-		if(  (err = network_receive_file( my_client_socket, filename, len )) != NULL  ) {
+		if(  len == nwc_game_t::CHUNKED  ) {
+			err = network_receive_chunked_file( my_client_socket, filename );
+		}
+		else {
+			err = network_receive_file( my_client_socket, filename, len );
+		}
+		if(  err != NULL  ) {
 			goto end;
 		}
 		// Knightly : update iteration limits
@@ -276,6 +342,54 @@ end:
 }
 
 
+network_send_stream_t::network_send_stream_t(SOCKET s) :
+	rdwr_stream_t(true),
+	sock(s)
+{
+	status = sock != INVALID_SOCKET ? STATUS_OK : STATUS_ERR_NOT_EXISTING;
+}
+
+
+size_t network_send_stream_t::read(void *, size_t)
+{
+	assert(false);
+	return 0;
+}
+
+
+size_t network_send_stream_t::write(const void *buf, size_t len)
+{
+	const char *data = (const char *)buf;
+	size_t sent = 0;
+	while(  sent < len  ) {
+		const uint16 n = (uint16)min( len - sent, (size_t)32768 );
+		const uint8 header[2] = { (uint8)(n & 0xFF), (uint8)(n >> 8) };
+		uint16 count;
+		if(  !network_send_data( sock, (const char *)header, 2, count, 250 )  ||  count != 2  ||
+			!network_send_data( sock, data + sent, n, count, 250 )  ||  count != n  ) {
+			status = STATUS_ERR_FULL;
+			return 0;
+		}
+		sent += n;
+	}
+	return sent;
+}
+
+
+bool network_send_stream_t::finish()
+{
+	if(  status != STATUS_OK  ) {
+		return false;
+	}
+	const uint8 header[2] = { 0, 0 };
+	uint16 count;
+	if(  !network_send_data( sock, (const char *)header, 2, count, 250 )  ||  count != 2  ) {
+		status = STATUS_ERR_FULL;
+	}
+	return status == STATUS_OK;
+}
+
+
 const char *network_send_file( uint32 client_id, const char *filename )
 {
 	FILE *fp = dr_fopen(filename,"rb");
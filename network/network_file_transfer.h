@@ -30,6 +30,36 @@ const char *network_send_file( uint32 client_id, const char *filename );
 // receive file (directly to disk)
 char const* network_receive_file(SOCKET const s, char const* const save_as, const sint32 length, const sint32 timeout=10000 );
 
+// receive file sent in chunks of unknown total length (directly to disk)
+char const* network_receive_chunked_file(SOCKET const s, char const* const save_as, const sint32 timeout=60000 );
+
+#ifndef NETTOOL
+#include "../io/rdwr/rdwr_stream.h"
+
+/**
+ * Sends everything written to it to a client as chunks: a 16 bit length, then the data.
+ * An empty chunk ends the transfer. Used as tee while saving the game for a client.
+ */
+class network_send_stream_t : public rdwr_stream_t
+{
+public:
+	network_send_stream_t(SOCKET s);
+
+	/// @copydoc rdwr_stream_t::read
+	size_t read(void *buf, size_t len) OVERRIDE;
+
+	/// @copydoc rdwr_stream_t::write
+	size_t write(const void *buf, size_t len) OVERRIDE;
+
+	/// sends the end marker
+	/// @return false if the transfer failed
+	bool finish();
+
+private:
+	SOCKET sock;
+};
+#endif
+
 /**
  * Use HTTP POST request to submit poststr to an HTTP server
  * Any response is saved to the file given by localname (pass NULL to ignore response)
@@ -4,6 +4,7 @@
  */
 
 #include "../simdebug.h"
+#include <string.h>
 #include "network_packet.h"
 #include "network_socket_list.h"
 
@@ -60,6 +61,23 @@ packet_t::packet_t(SOCKET sender) : memory_rw_t(buf,MAX_PACKET_LEN,false)
 }
 
 
+packet_t::packet_t(SOCKET sender, uint16 id_, const uint8 *data, uint16 len) : memory_rw_t(buf,MAX_PACKET_LEN,false),
+	size(HEADER_SIZE + len),
+	version(NETWORK_VERSION),
+	id(id_),
+	sock(sender),
+	error(len > MAX_PACKET_LEN - HEADER_SIZE),
+	ready(!error),
+	count(size)
+{
+	if (!error) {
+		memcpy(buf + HEADER_SIZE, data, len);
+		set_max_size(size);
+	}
+	set_index(HEADER_SIZE);
+}
+
+
 void packet_t::recv()
 {
 	if (error  ||  ready) {
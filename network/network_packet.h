@@ -54,6 +54,13 @@ public:
 	 */
 	packet_t(SOCKET s);
 
+	/**
+	 * constructor: packet is in loading-mode, fully received as part of a batch
+	 * @param s socket from where the batch was received
+	 * @param data the data after the header
+	 */
+	packet_t(SOCKET s, uint16 id, const uint8 *data, uint16 len);
+
 	/**
 	 * start/continue sending
 	 * sets bools ready or error
@@ -75,6 +82,10 @@ public:
 	bool check_version() const { return is_saving() || (version <= NETWORK_VERSION); }
 
 	uint16 get_id() const { return id; }
+
+	/// the data after the header, only valid while writing and before sending
+	const uint8 *get_data() const { return buf + HEADER_SIZE; }
+	uint16 get_data_size() const { return get_current_index() - HEADER_SIZE; }
 	void set_id(uint16 id_) { id = id_; }
 
 	SOCKET get_sender() { return sock; }
@@ -21,12 +21,17 @@ bool connection_info_t::operator==(const connection_info_t& other) const
 
 void socket_info_t::reset()
 {
+	socket_list_t::lock();
 	delete packet;
 	packet = NULL;
 	while(!send_queue.empty()) {
 		packet_t *p = send_queue.remove_first();
 		delete p;
 	}
+	while(!held_back_queue.empty()) {
+		delete held_back_queue.remove_first();
+	}
+	hold_back = false;
 	if (socket != INVALID_SOCKET) {
 		network_close_socket(socket);
 	}
@@ -35,6 +40,8 @@ void socket_info_t::reset()
 	}
 	socket = INVALID_SOCKET;
 	player_unlocked = 0;
+	send_failed = false;
+	socket_list_t::unlock();
 }
 
 
@@ -64,14 +71,16 @@ network_command_t* socket_info_t::receive_nwc()
 }
 
 
-void socket_info_t::process_send_queue()
+bool socket_info_t::process_send_queue()
 {
+	bool ok = true;
+	socket_list_t::lock();
 	while(!send_queue.empty()) {
 		packet_t *p = send_queue.front();
 		p->send(socket, false);
 		if (p->has_failed()) {
-			// close this client, clear the send_queue
-			socket_list_t::remove_client(socket);
+			// the caller closes this client, which clears the send_queue
+			ok = false;
 			break;
 		}
 		else if (p->is_ready()) {
@@ -84,21 +93,52 @@ void socket_info_t::process_send_queue()
 			break;
 		}
 	}
+	socket_list_t::unlock();
+	return ok;
 }
 
 
 void socket_info_t::send_queue_append(packet_t *p)
 {
 	if (p) {
+		socket_list_t::lock();
 		if (!p->has_failed()) {
-			send_queue.append(p);
+			if (hold_back) {
+				held_back_queue.append(p);
+			}
+			else {
+				send_queue.append(p);
+			}
 		}
 		else {
 			delete p;
 		}
+		socket_list_t::unlock();
 	}
 }
 
+
+void socket_info_t::set_hold_back(bool yes)
+{
+	socket_list_t::lock();
+	if (yes) {
+		// send the pending packets completely, the client must not receive them after the game
+		network_flush_broadcasts();
+		while(!send_queue.empty()) {
+			packet_t *p = send_queue.remove_first();
+			p->send(socket, true);
+			delete p;
+		}
+	}
+	else {
+		while(!held_back_queue.empty()) {
+			send_queue.append(held_back_queue.remove_first());
+		}
+	}
+	hold_back = yes;
+	socket_list_t::unlock();
+}
+
 void socket_info_t::rdwr(packet_t *p)
 {
 	address.rdwr(p);
@@ -119,6 +159,10 @@ uint32 socket_list_t::playing_clients;
  */
 uint32 socket_list_t::server_sockets;
 
+#ifdef MULTI_THREAD
+pthread_mutex_t socket_list_t::mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+#endif
+
 /**
  * book-keeping for the number of connected / playing clients
  */
@@ -143,15 +187,18 @@ void socket_list_t::book_state_change(uint8 state, sint8 incr)
 
 void socket_list_t::change_state(uint32 id, uint8 new_state)
 {
+	lock();
 	book_state_change(list[id]->state, -1);
 	list[id]->state = new_state;
 	list[id]->player_unlocked = 0;
 	book_state_change(list[id]->state, +1);
+	unlock();
 }
 
 
 void socket_list_t::reset()
 {
+	lock();
 	FOR(vector_tpl<socket_info_t*>, const i, list) {
 		i->reset();
 	}
@@ -162,11 +209,13 @@ void socket_list_t::reset()
 	// Knightly : clear the limit sets
 	nwc_routesearch_t::reset();
 #endif
+	unlock();
 }
 
 
 void socket_list_t::reset_clients()
 {
+	lock();
 	for(uint32 j=server_sockets; j<list.get_count(); j++) {
 		list[j]->reset();
 	}
@@ -176,16 +225,19 @@ void socket_list_t::reset_clients()
 	// Knightly : clear the limit sets
 	nwc_routesearch_t::reset();
 #endif
+	unlock();
 }
 
 
 void socket_list_t::add_client( SOCKET sock, uint32 ip )
 {
 	dbg->message("socket_list_t::add_client", "add client socket[%d] at address %xd", sock, ip);
+	lock();
 	uint32 i = list.get_count();
 	// check whether socket already added
 	for(  uint32 j=server_sockets;  j<list.get_count();  j++  ) {
 		if(  list[j]->socket == sock  &&  list[j]->state != socket_info_t::inactive  ) {
+			unlock();
 			return;
 		}
 		if(  list[j]->state == socket_info_t::inactive  &&  i == list.get_count()  ) {
@@ -198,6 +250,7 @@ void socket_list_t::add_client( SOCKET sock, uint32 ip )
 	list[i]->socket = sock;
 	list[i]->address = net_address_t(ip, 0);
 	change_state( i, socket_info_t::connected );
+	unlock();
 
 	network_set_socket_nodelay( sock );
 }
@@ -218,8 +271,10 @@ void socket_list_t::add_server( SOCKET sock )
 		}
 	}
 	if (i == server_sockets) {
+		lock();
 		list.insert_at(server_sockets, new socket_info_t());
 		server_sockets++;
+		unlock();
 	}
 	list[i]->socket = sock;
 	change_state(i, socket_info_t::server);
@@ -243,6 +298,7 @@ void socket_list_t::add_server( SOCKET sock )
 bool socket_list_t::remove_client( SOCKET sock )
 {
 	dbg->message("socket_list_t::remove_client", "remove client socket[%d]", sock);
+	lock();
 	for(uint32 j=0; j<list.get_count(); j++) {
 		if (list[j]->socket == sock) {
 
@@ -262,9 +318,11 @@ bool socket_list_t::remove_client( SOCKET sock )
 			nwc_routesearch_t::remove_client_entry(j);
 #endif
 			network_close_socket(sock);
+			unlock();
 			return true;
 		}
 	}
+	unlock();
 	return false;
 }
 
@@ -326,13 +384,23 @@ void socket_list_t::send_all(network_command_t* nwc, bool only_playing_clients)
 	if (nwc == NULL) {
 		return;
 	}
+	send_all(nwc->get_packet(), only_playing_clients);
+}
+
+
+void socket_list_t::send_all(const packet_t *p, bool only_playing_clients)
+{
+	if (p == NULL) {
+		return;
+	}
+	lock();
 	for(uint32 i=server_sockets; i<list.get_count(); i++) {
 		if (list[i]->is_active()  &&  list[i]->socket!=INVALID_SOCKET
 			&& (!only_playing_clients || list[i]->state == socket_info_t::playing || list[i]->state == socket_info_t::connected)) {
-			packet_t *p = nwc->copy_packet();
-			list[i]->send_queue_append(p);
+			list[i]->send_queue_append(new packet_t(*p));
 		}
 	}
+	unlock();
 }
 
 
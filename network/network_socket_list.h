@@ -14,6 +14,10 @@
 #include "../utils/plainstring.h"
 #include "../simconst.h"
 
+#ifdef MULTI_THREAD
+#include "../utils/simthread.h"
+#endif
+
 class network_command_t;
 class packet_t;
 
@@ -50,6 +54,13 @@ private:
 	packet_t *packet;
 	slist_tpl<packet_t *> send_queue;
 
+	/// commands queued while the client receives a game snapshot
+	slist_tpl<packet_t *> held_back_queue;
+	bool hold_back;
+
+public:
+	/// the send thread could not send to this client, it must be removed by the main thread
+	bool send_failed;
 
 public:
 	enum {
@@ -64,7 +75,7 @@ public:
 
 	SOCKET socket;
 
-	socket_info_t() : connection_info_t(), packet(0), send_queue(), state(inactive), socket(INVALID_SOCKET), player_unlocked(0) {}
+	socket_info_t() : connection_info_t(), packet(0), send_queue(), held_back_queue(), hold_back(false), send_failed(false), state(inactive), socket(INVALID_SOCKET), player_unlocked(0) {}
 
 	~socket_info_t();
 
@@ -84,12 +95,22 @@ public:
 	network_command_t* receive_nwc();
 
 	/**
-	 *
+	 * sends as much of the send queue as possible without blocking
+	 * @return false if an error occurred and the client must be removed
 	 */
-	void process_send_queue();
+	bool process_send_queue();
+
+	bool has_pending_sends() const { return !send_queue.empty(); }
 
 	void send_queue_append(packet_t *p);
 
+	/**
+	 * if true, appended packets are kept back until hold back is switched off again,
+	 * then they are moved to the send queue
+	 * switching on sends the pending packets immediately
+	 */
+	void set_hold_back(bool yes);
+
 	/**
 	 * rdwr client information to packet
 	 */
@@ -120,7 +141,22 @@ private:
 	static uint32 playing_clients;
 	static uint32 server_sockets;
 
+#ifdef MULTI_THREAD
+	static pthread_mutex_t mutex;
+#endif
+
 public:
+	/**
+	 * guards the list and the send queues against the send thread of the server
+	 * (recursive, no-op without MULTI_THREAD)
+	 */
+#ifdef MULTI_THREAD
+	static void lock() { pthread_mutex_lock(&mutex); }
+	static void unlock() { pthread_mutex_unlock(&mutex); }
+#else
+	static void lock() {}
+	static void unlock() {}
+#endif
 
 	static uint32 get_server_sockets() { return server_sockets; }
 	static uint32 get_connected_clients() { return connected_clients; }
@@ -186,6 +222,12 @@ public:
 	 */
 	static void send_all(network_command_t* nwc, bool only_playing_clients);
 
+	/**
+	 * send a copy of the packet to all clients
+	 * @param only_playing_clients if true then send only to playing clients
+	 */
+	static void send_all(const packet_t *p, bool only_playing_clients);
+
 	static void change_state(uint32 id, uint8 new_state);
 
 	/**
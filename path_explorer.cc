@@ -500,6 +500,7 @@ path_explorer_t::compartment_t::compartment_t()
 	catg_name = NULL;
 	class_name = NULL;
 	step_count = 0;
+	publish_count = 0;
 
 	paths_available = false;
 	refresh_completed = true;
@@ -609,6 +610,7 @@ void path_explorer_t::compartment_t::reset(const bool reset_finished_set)
 
 	if (reset_finished_set)
 	{
+		publish_count++;
 		if (finished_matrix)
 		{
 			for (uint16 i = 0; i < finished_halt_count; ++i)
@@ -1765,6 +1767,7 @@ void path_explorer_t::compartment_t::step()
 				}
 
 				// transfer working to finished
+				publish_count++;
 				finished_matrix = working_matrix;
 				working_matrix = NULL;
 				finished_halt_index_map = working_halt_index_map;
@@ -2113,6 +2116,10 @@ void path_explorer_t::compartment_t::rdwr(loadsave_t* file)
 
 	bool finished_matrix_live = finished_matrix != NULL;
 	file->rdwr_bool(finished_matrix_live);
+	if (file->is_loading())
+	{
+		publish_count++;
+	}
 
 	if (finished_matrix_live)
 	{
@@ -300,6 +300,7 @@ private:
 		const char *catg_name;	// Name of the category
 		char *class_name;		// Name of the class
 		uint16 step_count;		// number of steps done so far for a path refresh request
+		uint32 publish_count;	// increased whenever the finished paths change
 
 		// coordination flags
 		bool paths_available;
@@ -415,6 +416,7 @@ private:
 		bool are_paths_available() const { return paths_available; }
 		bool is_refresh_completed() const { return refresh_completed; }
 		bool is_refresh_requested() const { return refresh_requested; }
+		uint32 get_publish_count() const { return publish_count; }
 
 		// Note that these are only used for the client/server synchronisation checklist for diagnostic purposes.
 		uint8 get_current_phase() const { return current_phase; }
@@ -550,6 +552,12 @@ public:
 
 	inline static void set_absolute_limits_external() { compartment_t::set_absolute_limits();  }
 
+	/**
+	 * Changes whenever the paths of this category and class are published or reset,
+	 * so results of route searches may be cached as long as it stays the same.
+	 */
+	static uint32 get_publish_count(uint8 catg, uint8 g_class = 0) { return goods_compartment[catg][g_class].get_publish_count(); }
+
 	inline static bool get_must_refresh_on_loading() { return must_refresh_on_loading; }
 	inline static void set_must_refresh_on_loading() { must_refresh_on_loading = true; }
 	inline static void reset_must_refresh_on_loading() { must_refresh_on_loading = false; }
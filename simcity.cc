@@ -375,11 +375,105 @@ public:
 	}
 };
 
+/**
+ * The 7x7 tiles around a position as bit boards, bit x+7*y for the tile (x-3,y-3).
+ * This way a rule is tested in all rotations with a few mask operations.
+ */
+enum {
+	RULE_BOARD_ROAD,       // public road
+	RULE_BOARD_FUNDAMENT,
+	RULE_BOARD_HOUSE,
+	RULE_BOARD_NATURE,     // nature/empty
+	RULE_BOARD_WAY_SLOPE,  // slope suitable for ways
+	RULE_BOARD_STOP,
+	MAX_RULE_BOARDS
+};
+
+struct rule_board_t {
+	bool filled;
+	uint64 inside;              ///< tiles on the map
+	uint64 set[MAX_RULE_BOARDS];
+
+	rule_board_t() : filled(false) {}
+};
+
+/// tiles, which are tested by any rule in any rotation
+static uint64 rule_tiles;
+static uint64 rule_board_tiles[MAX_RULE_BOARDS];
+
 class rule_t {
 public:
 	sint16  distribution_weight;
 	vector_tpl<rule_entry_t> rule;
-	rule_t(uint32 count=0) : distribution_weight(0), rule(count) {}
+
+	/// compiled rule for each rotation: tested tiles, and tiles which must be set or clear in each board
+	uint64 tiles[4];
+	uint64 must_set[4][MAX_RULE_BOARDS];
+	uint64 must_clear[4][MAX_RULE_BOARDS];
+	bool impossible; ///< entries outside the 7x7 area never match
+
+	rule_t(uint32 count=0) : distribution_weight(0), rule(count), impossible(false) {}
+
+	void compile()
+	{
+		MEMZERO(tiles);
+		MEMZERO(must_set);
+		MEMZERO(must_clear);
+		impossible = false;
+		FOR(vector_tpl<rule_entry_t>, const& r, rule) {
+			if(  r.x > 6  ||  r.y > 6  ) {
+				impossible = true;
+				return;
+			}
+			for(  int rotation = 0;  rotation < 4;  rotation++  ) {
+				uint8 x,y;
+				switch (rotation) {
+					default:
+					case 0: x=r.x; y=r.y; break;
+					case 1: x=r.y; y=6-r.x; break;
+					case 2: x=6-r.x; y=6-r.y; break;
+					case 3: x=6-r.y; y=r.x; break;
+				}
+				const uint64 bit = (uint64)1 << (x + 7*y);
+				tiles[rotation] |= bit;
+				switch (r.flag) {
+					case 's': must_set[rotation][RULE_BOARD_ROAD] |= bit; break;
+					case 'S': must_clear[rotation][RULE_BOARD_ROAD] |= bit; break;
+					case 'h': must_set[rotation][RULE_BOARD_HOUSE] |= bit; break;
+					case 'H': must_clear[rotation][RULE_BOARD_FUNDAMENT] |= bit; break;
+					case 'n': must_set[rotation][RULE_BOARD_NATURE] |= bit; break;
+					case 'U': must_set[rotation][RULE_BOARD_WAY_SLOPE] |= bit; break;
+					case 'u': must_clear[rotation][RULE_BOARD_WAY_SLOPE] |= bit; break;
+					case 't': must_set[rotation][RULE_BOARD_STOP] |= bit; break;
+					case 'T': must_clear[rotation][RULE_BOARD_STOP] |= bit; break;
+					default: ;
+						// ignore
+				}
+			}
+		}
+	}
+
+	/// @return true if the rule matches in any rotation
+	bool matches(const rule_board_t &board) const
+	{
+		if(  impossible  ) {
+			return false;
+		}
+		for(  int rotation = 0;  rotation < 4;  rotation++  ) {
+			// outside of the map => cannot apply this rule
+			if(  tiles[rotation] & ~board.inside  ) {
+				continue;
+			}
+			uint64 failed = 0;
+			for(  int i = 0;  i < MAX_RULE_BOARDS;  i++  ) {
+				failed |= (must_set[rotation][i] & ~board.set[i]) | (must_clear[rotation][i] & board.set[i]);
+			}
+			if(  failed == 0  ) {
+				return true;
+			}
+		}
+		return false;
+	}
 
 	void rdwr(loadsave_t* file)
 	{
@@ -405,6 +499,25 @@ static vector_tpl<rule_t *> house_rules;
 // and road rules
 static vector_tpl<rule_t *> road_rules;
 
+
+/// compiles all rules and collects the tiles to classify for them
+static void compile_rules()
+{
+	rule_tiles = 0;
+	MEMZERO(rule_board_tiles);
+	for(  int type = 0;  type < 2;  type++  ) {
+		FOR(vector_tpl<rule_t *>, const r, type == 0 ? house_rules : road_rules) {
+			r->compile();
+			for(  int rotation = 0;  rotation < 4;  rotation++  ) {
+				rule_tiles |= r->tiles[rotation];
+				for(  int i = 0;  i < MAX_RULE_BOARDS;  i++  ) {
+					rule_board_tiles[i] |= r->must_set[rotation][i] | r->must_clear[rotation][i];
+				}
+			}
+		}
+	}
+}
+
 /**
  * Symbols in rules:
  * S = not a road
@@ -646,77 +759,45 @@ bool stadt_t::bewerte_loc_has_public_road(const koord pos)
 
 /*
 * @param pos position to check
-* @param regel the rule to evaluate
-* @return true on match, false otherwise
+* @param board receives the classification of the tiles around pos used by the rules
 */
 
-bool stadt_t::bewerte_loc(const koord pos, const rule_t &regel, int rotation)
+void stadt_t::bewerte_board(const koord pos, rule_board_t &board)
 {
-	//printf("Test for (%s) in rotation %d\n", pos.get_str(), rotation);
-	koord k;
-
-	FOR(vector_tpl<rule_entry_t>, const& r, regel.rule) {
-		uint8 x,y;
-		switch (rotation) {
-			default:
-			case   0: x=r.x; y=r.y; break;
-			case  90: x=r.y; y=6-r.x; break;
-			case 180: x=6-r.x; y=6-r.y; break;
-			case 270: x=6-r.y; y=r.x; break;
+	board.inside = 0;
+	MEMZERO(board.set);
+	for(  int bit = 0;  bit < 49;  bit++  ) {
+		const uint64 mask = (uint64)1 << bit;
+		if(  (rule_tiles & mask) == 0  ) {
+			continue;
 		}
-
-		const koord k(pos.x+x-3, pos.y+y-3);
+		const koord k(pos.x + bit%7 - 3, pos.y + bit/7 - 3);
 		const grund_t* gr = welt->lookup_kartenboden(k);
 		if (gr == NULL) {
-			// outside of the map => cannot apply this rule
-			return false;
+			continue;
 		}
-		switch (r.flag) {
-			case 's':
-				// public road?
-				if (!bewerte_loc_has_public_road(k)) return false;
-				break;
-			case 'S':
-				// no road at all, not even a private one?
-				if (bewerte_loc_has_public_road(k)) return false;
-				break;
-			case 'h':
-				// is house.
-				if (gr->get_typ() != grund_t::fundament  ||
-				    (gr->obj_bei(0) && gr->obj_bei(0)->get_typ()!=obj_t::gebaeude))
-				{
-					return false;
-				}
-				break;
-			case 'H':
-				// no house
-				if (gr->get_typ() == grund_t::fundament) return false;
-				break;
-			case 'n':
-				// nature/empty
-				if (!gr->ist_natur() || gr->kann_alle_obj_entfernen(NULL) != NULL) return false;
-				break;
-			case 'U':
-				// unbuildable for road
-				if (!slope_t::is_way(gr->get_grund_hang())) return false;
-				break;
-			case 'u':
-				// road may be buildable
-				if (slope_t::is_way(gr->get_grund_hang())) return false;
-				break;
-			case 't':
-				// here is a stop/extension building
-				if (!gr->is_halt()) return false;
-				break;
-			case 'T':
-				// no stop
-				if (gr->is_halt()) return false;
-				break;
-			default: ;
-				// ignore
+		board.inside |= mask;
+
+		if(  (rule_board_tiles[RULE_BOARD_ROAD] & mask)  &&  bewerte_loc_has_public_road(k)  ) {
+			board.set[RULE_BOARD_ROAD] |= mask;
+		}
+		if(  gr->get_typ() == grund_t::fundament  ) {
+			board.set[RULE_BOARD_FUNDAMENT] |= mask;
+			if(  !(gr->obj_bei(0) && gr->obj_bei(0)->get_typ()!=obj_t::gebaeude)  ) {
+				board.set[RULE_BOARD_HOUSE] |= mask;
+			}
+		}
+		if(  (rule_board_tiles[RULE_BOARD_NATURE] & mask)  &&  gr->ist_natur()  &&  gr->kann_alle_obj_entfernen(NULL) == NULL  ) {
+			board.set[RULE_BOARD_NATURE] |= mask;
+		}
+		if(  slope_t::is_way(gr->get_grund_hang())  ) {
+			board.set[RULE_BOARD_WAY_SLOPE] |= mask;
+		}
+		if(  gr->is_halt()  ) {
+			board.set[RULE_BOARD_STOP] |= mask;
 		}
 	}
-	return true;
+	board.filled = true;
 }
 
 
@@ -724,16 +805,13 @@ bool stadt_t::bewerte_loc(const koord pos, const rule_t &regel, int rotation)
  * Check rule in all transformations at given position
  * @note but the rules should explicitly forbid building then?!?
  */
-sint32 stadt_t::bewerte_pos(const koord pos, const rule_t &regel)
+sint32 stadt_t::bewerte_pos(const koord pos, rule_board_t &board, const rule_t &regel)
 {
-	// will be called only a single time, so we can stop after a single match
-	if(bewerte_loc(pos, regel,   0) ||
-		 bewerte_loc(pos, regel,  90) ||
-		 bewerte_loc(pos, regel, 180) ||
-		 bewerte_loc(pos, regel, 270)) {
-		return 1;
-	}
-	return 0;
+	// the tiles are classified only once for all rules tested here
+	if(  !board.filled  ) {
+		bewerte_board(pos, board);
+	}
+	return regel.matches(board) ? 1 : 0;
 }
 
 bool stadt_t::maybe_build_road(koord k, bool map_generation)
@@ -745,6 +823,7 @@ bool stadt_t::maybe_build_road(koord k, bool map_generation)
 	}
 
 	best_strasse.reset(k);
+	rule_board_t board;
 	const uint32 num_road_rules = road_rules.get_count();
 	uint32 offset = simrand(num_road_rules, "bool stadt_t::maybe_build_road");	// start with random rule
 	for (uint32 i = 0; i < num_road_rules  &&  !best_strasse.found(); i++) {
@@ -752,7 +831,7 @@ bool stadt_t::maybe_build_road(koord k, bool map_generation)
 		sint32 rd = 8 + road_rules[rule]->distribution_weight;
 
 		if (simrand(rd, "void stadt_t::bewerte_strasse") == 0) {
-			best_strasse.check(k, bewerte_pos(k, *road_rules[rule]));
+			best_strasse.check(k, bewerte_pos(k, board, *road_rules[rule]));
 		}
 	}
 
@@ -766,10 +845,10 @@ bool stadt_t::maybe_build_road(koord k, bool map_generation)
 }
 
 
-void stadt_t::bewerte_haus(koord k, sint32 rd, const rule_t &regel)
+void stadt_t::bewerte_haus(koord k, rule_board_t &board, sint32 rd, const rule_t &regel)
 {
 	if (simrand(rd, "stadt_t::bewerte_haus") == 0) {
-		best_haus.check(k, bewerte_pos(k, regel));
+		best_haus.check(k, bewerte_pos(k, board, regel));
 	}
 }
 
@@ -970,6 +1049,7 @@ bool stadt_t::cityrules_init(const std::string &objfilename)
 			dbg->message("stadt_t::cityrules_init()", "Road-Rule %d: Pos (%d,%d) Flag %d\n",i,road_rules[i]->rule[j].x,road_rules[i]->rule[j].y,road_rules[i]->rule[j].flag);
 
 	}
+	compile_rules();
 	return true;
 }
 
@@ -1070,7 +1150,9 @@ void stadt_t::cityrules_rdwr(loadsave_t *file)
 		}
 		road_rules[i]->rdwr(file);
 	}
-
+	if (file->is_loading()) {
+		compile_rules();
+	}
 }
 
 /**
@@ -2830,10 +2912,10 @@ void stadt_t::new_month()
 
 void stadt_t::calc_growth()
 {
-	// now iterate over all factories to get the ratio of producing version non-producing factories
+	// now iterate over our factories to get the ratio of producing version non-producing factories
 	// we use the incoming storage as a measure and we will only look for end consumers (power stations, markets)
 
-	FOR(const vector_tpl<fabrik_t*>, const& fab, welt->get_fab_list())
+	FOR(const vector_tpl<fabrik_t*>, const& fab, city_factories)
 	{
 		if(fab && fab->get_city() == this && fab->get_consumers().empty() && !fab->get_suppliers().empty())
 		{
@@ -5466,11 +5548,12 @@ void stadt_t::build(bool new_town, bool map_generation)
 
 			// since only a single location is checked, we can stop after we have found a positive rule
 			best_haus.reset(k);
+			rule_board_t board;
 			const uint32 num_house_rules = house_rules.get_count();
 			uint32 offset = simrand(num_house_rules, "void stadt_t::build");	// start with random rule
 			for(  uint32 i = 0;  i < num_house_rules  &&  !best_haus.found();  i++  ) {
 				uint32 rule = ( i+offset ) % num_house_rules;
-				bewerte_haus(k, 8 + house_rules[rule]->distribution_weight, *house_rules[rule]);
+				bewerte_haus(k, board, 8 + house_rules[rule]->distribution_weight, *house_rules[rule]);
 			}
 			// one rule applied?
 			if(  best_haus.found()  ) {
@@ -5590,11 +5673,12 @@ void stadt_t::build(bool new_town, bool map_generation)
 
 			// we can stop after we have found a positive rule
 			best_haus.reset(k);
+			rule_board_t board;
 			const uint32 num_house_rules = house_rules.get_count();
 			uint32 offset = simrand(num_house_rules, "void stadt_t::build");	// start with random rule
 			for (uint32 i = 0; i < num_house_rules  &&  !best_haus.found(); i++) {
 				uint32 rule = ( i+offset ) % num_house_rules;
-				bewerte_haus(k, 8 + house_rules[rule]->distribution_weight, *house_rules[rule]);
+				bewerte_haus(k, board, 8 + house_rules[rule]->distribution_weight, *house_rules[rule]);
 			}
 			// one rule applied?
 			if (best_haus.found()) {
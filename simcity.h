@@ -28,6 +28,7 @@ class karte_ptr_t;
 class player_t;
 class fabrik_t;
 class rule_t;
+struct rule_board_t;
 struct route_range_specification;
 
 // For private subroutines
@@ -418,7 +419,11 @@ private:
 	 * @return true on match, false otherwise
 	 */
 	bool bewerte_loc_has_public_road(koord pos);
-	bool bewerte_loc(koord pos, const rule_t &regel, int rotation);
+
+	/**
+	 * Classifies the tiles around pos, which are used by the rules.
+	 */
+	void bewerte_board(koord pos, rule_board_t &board);
 
 	/*
 	 * evaluates the location, tests again all rules, and caches the result
@@ -428,10 +433,10 @@ private:
 	/**
 	 * Check rule in all transformations at given position
 	 */
-	sint32 bewerte_pos(koord pos, const rule_t &regel);
+	sint32 bewerte_pos(koord pos, rule_board_t &board, const rule_t &regel);
 
 	void bewerte_strasse(koord pos, sint32 rd, const rule_t &regel);
-	void bewerte_haus(koord pos, sint32 rd, const rule_t &regel);
+	void bewerte_haus(koord pos, rule_board_t &board, sint32 rd, const rule_t &regel);
 
 	bool private_car_route_finding_in_progress = false;
 
@@ -99,6 +99,25 @@ public:
 };
 
 
+/**
+ * Orders factories by their first tile at or after min_pos, row by row.
+ */
+class first_tile_in_rect_cmp
+{
+private:
+	const koord min_pos;
+public:
+	first_tile_in_rect_cmp(const koord& min_pos) : min_pos(min_pos) {}
+
+	bool operator()(const fabrik_t* a, const fabrik_t* b) const
+	{
+		const koord pa( max(min_pos.x, a->get_pos().x), max(min_pos.y, a->get_pos().y) );
+		const koord pb( max(min_pos.x, b->get_pos().x), max(min_pos.y, b->get_pos().y) );
+		return pa.y < pb.y  ||  (pa.y == pb.y  &&  pa.x < pb.x);
+	}
+};
+
+
 void ware_production_t::init_stats()
 {
 	for(  int m=0;  m<MAX_MONTH;  ++m  ) {
@@ -819,6 +838,7 @@ fabrik_t::fabrik_t(loadsave_t* file) :
 	delta_t_sum = 0;
 	delta_amount = 0;
 	delta_amount_remainder = 0;
+	consumer_routes_generation = 0;
 	total_input = total_transit = total_output = 0;
 	sector = unknown;
 	status = nothing;
@@ -874,6 +894,7 @@ fabrik_t::fabrik_t(koord3d pos_, player_t* owner, const factory_desc_t* desc, si
 	delta_t_sum = 0;
 	delta_amount = 0;
 	delta_amount_remainder = 0;
+	consumer_routes_generation = 0;
 	activity_count = 0;
 	currently_producing = false;
 	transformer_connected = NULL;
@@ -1306,16 +1327,9 @@ vector_tpl<fabrik_t *> &fabrik_t::sind_da_welche(koord min_pos, koord max_pos)
 	static vector_tpl <fabrik_t*> factory_list(16);
 	factory_list.clear();
 
-	for(int y=min_pos.y; y<=max_pos.y; y++) {
-		for(int x=min_pos.x; x<=max_pos.x; x++) {
-			fabrik_t *fab=get_fab(koord(x,y));
-			if(fab) {
-				if (factory_list.append_unique(fab)) {
-//DBG_MESSAGE("fabrik_t::sind_da_welche()","appended factory %s at (%i,%i)",gr->first_obj()->get_fabrik()->get_desc()->get_name(),x,y);
-				}
-			}
-		}
-	}
+	welt->get_factory_grid().get_in_rect( min_pos, max_pos, factory_list );
+	// same order as scanning the rectangle row by row: by the first tile inside it
+	std::sort( factory_list.begin(), factory_list.end(), first_tile_in_rect_cmp(min_pos) );
 	return factory_list;
 }
 
@@ -2267,13 +2281,13 @@ void fabrik_t::remove_contracts(){
 
 void fabrik_t::step(uint32 delta_t)
 {
-	if(!has_calculated_intransit_percentages)
-	{
-		// Can only do it here (once after loading) as paths
-		// are not available when loading, even in finish_rd
-		calc_max_intransit_percentages();
-	}
+	step_production(delta_t);
+	step_distribution(delta_t);
+}
+
 
+void fabrik_t::step_production(uint32 delta_t)
+{
 	if(  delta_t==0  ) {
 		return;
 	}
@@ -2482,6 +2496,26 @@ void fabrik_t::step(uint32 delta_t)
 	if(  !desc->is_electricity_producer()  ) {
 		power = 0;
 	}
+}
+
+
+void fabrik_t::step_distribution(uint32 delta_t)
+{
+	if(!has_calculated_intransit_percentages)
+	{
+		// Can only do it here (once after loading) as paths
+		// are not available when loading, even in finish_rd
+		calc_max_intransit_percentages();
+	}
+
+	if(  delta_t==0  ) {
+		return;
+	}
+
+	const bool contracts = welt->get_settings().using_fab_contracts();
+	if(  contracts  ) {
+		distribute_contracts(delta_t);
+	}
 
 	delta_t_sum += delta_t;
 	if(  delta_t_sum > PRODUCTION_DELTA_T  ) {
@@ -2489,7 +2523,7 @@ void fabrik_t::step(uint32 delta_t)
 
 		// distribute, if there is more than 1 waiting ...
 		// Changed from the original 10 by jamespetts, July 2017
-		for(  uint32 product = 0;  product < output.get_count();  product++  )
+		for(  uint32 product = 0;  product < output.get_count()  &&  !contracts;  product++  )
 		{
 			const sint32 units = (sint32)(((sint64)output[product].menge * (sint64)(get_prodfactor())) >> ((sint64)DEFAULT_PRODUCTION_FACTOR_BITS + (sint64)precision_bits));
 			//if(  output[product].menge > (1 << precision_bits)  ||  output[product].menge*2 > output[product].max  )
@@ -2642,17 +2676,6 @@ void fabrik_t::step_contracts(uint32 delta_t){
 	if(  !desc->is_electricity_producer()  ) {
 		power = 0;
 	}
-
-	distribute_contracts(delta_t);
-
-	delta_t_sum += delta_t;
-	if(delta_t_sum > PRODUCTION_DELTA_T){
-		delta_t_sum %= PRODUCTION_DELTA_T;
-		recalc_factory_status();
-		rescale_delta();
-	}
-
-	advance_slot(delta_t);
 }
 
 void fabrik_t::rescale_delta(){
@@ -2984,7 +3007,7 @@ void fabrik_t::verteile_waren(const uint32 product)
 
 			// now search route
 			const uint32 transfer_time = (i.nearby_halt.distance * transfer_journey_time_factor) / 100;
-			current_journey_time = i.nearby_halt.halt->find_route(i.ware);
+			current_journey_time = find_consumer_route(i.nearby_halt.halt, i.ware, product);
 			if(current_journey_time < UINT32_MAX_VALUE)
 			{
 				current_journey_time += transfer_time;
@@ -3066,6 +3089,38 @@ void fabrik_t::verteile_waren(const uint32 product)
 	}
 }
 
+uint32 fabrik_t::find_consumer_route(halthandle_t halt, ware_t &ware, uint32 product)
+{
+	const uint32 generation = haltestelle_t::get_link_generation();
+	if(  consumer_routes_generation != generation  ) {
+		// the destination halts may have changed => all routes must be searched again
+		consumer_routes.clear();
+		consumer_routes_generation = generation;
+	}
+
+	// freight is always routed in class 0
+	const uint32 publish_count = path_explorer_t::get_publish_count( ware.get_desc()->get_catg_index() );
+	const koord zielpos = ware.get_zielpos();
+	const uint64 key = ((uint64)halt.get_id() << 40) | ((uint64)(product & 0xFF) << 32) | ((uint32)(uint16)zielpos.x << 16) | (uint16)zielpos.y;
+	const consumer_route_t *route = consumer_routes.access(key);
+	if(  route  &&  route->publish_count == publish_count  ) {
+		if(  route->journey_time < UINT32_MAX_VALUE  ) {
+			ware.set_ziel(route->ziel);
+			ware.set_zwischenziel(route->zwischenziel);
+		}
+		return route->journey_time;
+	}
+
+	consumer_route_t found;
+	found.journey_time = halt->find_route(ware);
+	found.ziel = ware.get_ziel();
+	found.zwischenziel = ware.get_zwischenziel();
+	found.publish_count = publish_count;
+	consumer_routes.set(key, found);
+	return found.journey_time;
+}
+
+
 stadt_t* fabrik_t::check_local_city()
 {
 	stadt_t* c = NULL;
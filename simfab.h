@@ -575,6 +575,31 @@ private:
 	 */
 	void verteile_waren(const uint32 product);
 
+	/**
+	 * Result of a route search from one of our halts to a consumer
+	 */
+	struct consumer_route_t
+	{
+		uint32 journey_time; ///< UINT32_MAX_VALUE if there is no route
+		halthandle_t ziel;
+		halthandle_t zwischenziel;
+		uint32 publish_count; ///< path_explorer_t::get_publish_count() of the goods category when found
+	};
+
+	/// key: start halt, product and position of the consumer
+	inthashtable_tpl<uint64, consumer_route_t, 16> consumer_routes;
+
+	/// haltestelle_t::get_link_generation() when the consumer_routes were found
+	uint32 consumer_routes_generation;
+
+	/**
+	 * Like haltestelle_t::find_route(), but takes the result from consumer_routes
+	 * as long as neither the paths of the goods category nor the halts linked
+	 * to the consumer have changed. Only depends on saved state, so the cache
+	 * may differ between server and client without changing the result.
+	 */
+	uint32 find_consumer_route(halthandle_t halt, ware_t &ware, uint32 product);
+
 	player_t *owner;
 	static karte_ptr_t welt;
 
@@ -954,6 +979,19 @@ public:
 	bool out_of_stock_selective();
 
 	void step(uint32 delta_t);                  // factory muss auch arbeiten ("factory must also work")
+
+	/**
+	 * First half of step(): production and consumption.
+	 * Touches only this factory, so it may run in parallel for different factories.
+	 */
+	void step_production(uint32 delta_t);
+
+	/**
+	 * Second half of step(): distributes the goods to the halts,
+	 * smoke and expansion. Must run serially in fab_list order.
+	 */
+	void step_distribution(uint32 delta_t);
+
 	void step_contracts(uint32 delta_t);
 
 	void distribute_contracts(uint32 delta_t);
@@ -75,30 +75,172 @@ inthashtable_tpl<sint32,halthandle_t,N_BAGS_LARGE> *haltestelle_t::all_koords =
 
 //uint8 haltestelle_t::status_step = 0;
 uint8 haltestelle_t::reconnect_counter = 0;
+uint32 haltestelle_t::link_generation = 0;
 
-// controls the halt iterator in step_all():
-static bool restart_halt_iterator = true;
+// the halts stepped in turn by step_all(), and the position in it
+static vector_tpl<halthandle_t> awake_halts;
+static uint32 awake_halt_index = 0;
+
+// remainder of the steps per call shared among the awake halts
+static uint32 awake_step_credit = 0;
+
+// the alarms of the sleeping halts, as a heap with the earliest first
+struct halt_alarm_t
+{
+	sint64 time;
+	halthandle_t halt;
+};
+
+static bool halt_alarm_later(const halt_alarm_t &a, const halt_alarm_t &b)
+{
+	return a.time > b.time  ||  (a.time == b.time  &&  a.halt.get_id() > b.halt.get_id());
+}
+
+static vector_tpl<halt_alarm_t> halt_alarms;
+
+// sleeping halts which got something to do since the last step_all()
+static vector_tpl<halthandle_t> halts_to_wake;
+#ifdef MULTI_THREAD
+static pthread_mutex_t halts_to_wake_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static bool halt_id_less(const halthandle_t &a, const halthandle_t &b)
+{
+	return a.get_id() < b.get_id();
+}
 
 void haltestelle_t::step_all()
 {
+	// forget the halts which fell asleep during the last call
+	uint32 j = 0;
+	for(  uint32 i = 0;  i < awake_halts.get_count();  i++  ) {
+		if(  awake_halts[i].is_bound()  &&  awake_halts[i]->awake  ) {
+			awake_halts[j++] = awake_halts[i];
+		}
+		else if(  i < awake_halt_index  ) {
+			awake_halt_index--;
+		}
+	}
+	while(  awake_halts.get_count() > j  ) {
+		awake_halts.pop_back();
+	}
+
+	// wake up in id order, as the threads add to halts_to_wake in any order
+	std::sort( halts_to_wake.begin(), halts_to_wake.end(), halt_id_less );
+	FOR(vector_tpl<halthandle_t>, const halt, halts_to_wake) {
+		if(  halt.is_bound()  &&  !halt->awake  ) {
+			halt->awake = true;
+			awake_halts.append( halt );
+		}
+	}
+	halts_to_wake.clear();
+
+	const sint64 now = welt->get_ticks();
+	while(  !halt_alarms.empty()  &&  halt_alarms[0].time <= now  ) {
+		std::pop_heap( halt_alarms.begin(), halt_alarms.end(), halt_alarm_later );
+		const halt_alarm_t alarm = halt_alarms.pop_back();
+		// a halt woken up earlier may have set a newer alarm meanwhile
+		if(  alarm.halt.is_bound()  &&  !alarm.halt->awake  &&  alarm.halt->alarm_time == alarm.time  ) {
+			alarm.halt->awake = true;
+			awake_halts.append( alarm.halt );
+		}
+	}
+
+	// 256 steps per call were shared among all halts; the awake ones get their share of them
 	const uint32 count = alle_haltestellen.get_count();
-	if (count)
+	if(  count == 0  ) {
+		return;
+	}
+	awake_step_credit += min(count, 256u) * awake_halts.get_count();
+	const uint32 loops = min(awake_step_credit / count, awake_halts.get_count());
+	awake_step_credit %= count;
+	for (uint32 i = 0; i < loops; ++i)
 	{
-		const uint32 loops = min(count, 256u);
-		static vector_tpl<halthandle_t>::iterator iter;
-		for (uint32 i = 0; i < loops; ++i)
-		{
-			if (restart_halt_iterator || iter == alle_haltestellen.end())
-			{
-				restart_halt_iterator = false;
-				iter = alle_haltestellen.begin();
+		if(  awake_halt_index >= awake_halts.get_count()  ) {
+			awake_halt_index = 0;
+		}
+		const halthandle_t halt = awake_halts[awake_halt_index++];
+		if(  halt.is_bound()  &&  halt->awake  ) {
+			halt->step();
+			if(  halt->is_idle()  ) {
+				halt->fall_asleep();
 			}
-			(*iter++)->step();
 		}
 	}
 }
 
 
+void haltestelle_t::reset_sleep_state()
+{
+	awake_halts.clear();
+	awake_halt_index = 0;
+	awake_step_credit = 0;
+	halt_alarms.clear();
+	halts_to_wake.clear();
+	FOR(vector_tpl<halthandle_t>, const halt, alle_haltestellen) {
+		halt->awake = true;
+		halt->alarm_time = 0;
+		awake_halts.append( halt );
+	}
+}
+
+
+bool haltestelle_t::is_idle() const
+{
+	if(  !categories_to_refresh_next_step.empty()  ) {
+		return false;
+	}
+	for(  uint8 i = 0;  i < goods_manager_t::get_max_catg_index();  i++  ) {
+		if(  cargo[i]  ) {
+			FOR(vector_tpl<ware_t>, const& ware, *cargo[i]) {
+				if(  ware.menge > 0  ) {
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+
+void haltestelle_t::fall_asleep()
+{
+	// look at the status now and then, as it also depends on the statistics
+	alarm_time = welt->get_ticks() + (welt->ticks_per_world_month >> 5);
+#ifdef MULTI_THREAD
+	const sint32 po = world()->get_parallel_operations();
+#else
+	const sint32 po = 1;
+#endif
+	for(  sint32 i = 0;  i < po;  i++  ) {
+		FOR(vector_tpl<transferring_cargo_t>, const& tc, transferring_cargoes[i]) {
+			alarm_time = min( alarm_time, tc.ready_time );
+		}
+	}
+	awake = false;
+	halt_alarm_t alarm;
+	alarm.time = alarm_time;
+	alarm.halt = self;
+	halt_alarms.append( alarm );
+	std::push_heap( halt_alarms.begin(), halt_alarms.end(), halt_alarm_later );
+}
+
+
+void haltestelle_t::wake_up()
+{
+	if(  awake  ) {
+		return;
+	}
+#ifdef MULTI_THREAD
+	pthread_mutex_lock( &halts_to_wake_mutex );
+#endif
+	halts_to_wake.append( self );
+#ifdef MULTI_THREAD
+	pthread_mutex_unlock( &halts_to_wake_mutex );
+#endif
+}
+
+
 static vector_tpl<convoihandle_t>stale_convois;
 static vector_tpl<linehandle_t>stale_lines;
 
@@ -358,9 +500,6 @@ halthandle_t haltestelle_t::create(loadsave_t *file)
  */
 void haltestelle_t::destroy(halthandle_t const halt)
 {
-	// just play safe: restart iterator at zero ...
-	restart_halt_iterator = true;
-
 	delete halt.get_rep();
 }
 
@@ -372,6 +511,11 @@ void haltestelle_t::destroy(halthandle_t const halt)
  */
 void haltestelle_t::destroy_all()
 {
+	awake_halts.clear();
+	awake_halt_index = 0;
+	awake_step_credit = 0;
+	halt_alarms.clear();
+	halts_to_wake.clear();
 	while (!alle_haltestellen.empty()) {
 		halthandle_t halt = alle_haltestellen.back();
 		destroy(halt);
@@ -386,6 +530,8 @@ haltestelle_t::haltestelle_t(loadsave_t* file)
 {
 	// NOTE: This is not called when saving.
 	last_loading_step = welt->get_steps();
+	awake = true;
+	alarm_time = 0;
 
 	const uint8 max_categories = goods_manager_t::get_max_catg_index();
 	const uint8 max_classes = max(goods_manager_t::passengers->get_number_of_classes(), goods_manager_t::mail->get_number_of_classes());
@@ -439,10 +585,12 @@ haltestelle_t::haltestelle_t(loadsave_t* file)
 	rdwr(file);
 
 	alle_haltestellen.append(self);
-	restart_halt_iterator = true;
+	awake_halts.append(self);
 
 	// Added by : Knightly
 	inauguration_time = 0;
+	around_stats_step = -1;
+	around_stats_generation = 0;
 }
 
 
@@ -451,7 +599,9 @@ haltestelle_t::haltestelle_t(koord k, player_t* player)
 	self = halthandle_t(this);
 	assert( !alle_haltestellen.is_contained(self) );
 	alle_haltestellen.append(self);
-	restart_halt_iterator = true;
+	awake = true;
+	alarm_time = 0;
+	awake_halts.append(self);
 
 	//markers[ self.get_id() ] = current_marker;
 
@@ -514,6 +664,8 @@ haltestelle_t::haltestelle_t(koord k, player_t* player)
 	// Added by : Knightly
 	//inauguration_time = dr_time();
 	inauguration_time = welt->get_ticks(); // Possibly more network safe than the original (commented out above)
+	around_stats_step = -1;
+	around_stats_generation = 0;
 
 	control_towers = 0;
 
@@ -544,6 +696,16 @@ haltestelle_t::~haltestelle_t()
 	if (i != 1) {
 		dbg->error("haltestelle_t::~haltestelle_t()", "handle %i found %i times in haltlist!", self.get_id(), i );
 	}
+	// the handle may be reused before step_all() drops it
+	for(  uint32 n = 0;  n < awake_halts.get_count();  n++  ) {
+		if(  awake_halts[n] == self  ) {
+			awake_halts.remove_at( n );
+			if(  n < awake_halt_index  ) {
+				awake_halt_index--;
+			}
+			break;
+		}
+	}
 
 	if(!welt->is_destroying())
 	{
@@ -1635,6 +1797,7 @@ uint32 haltestelle_t::reroute_goods(const uint8 catg)
 
 void haltestelle_t::add_factory(fabrik_t* fab)
 {
+	next_link_generation();
 	fab_list.append_unique(fab);
 }
 
@@ -1649,6 +1812,7 @@ void haltestelle_t::verbinde_fabriken()
 	// Do not do this any longer:
 	// this is a residue from when this used to do all of the recalculation.
 	//fab_list.clear();
+	next_link_generation();
 
 	if (tiles.begin() != tiles.end())
 	{
@@ -1743,6 +1907,7 @@ void haltestelle_t::verbinde_fabriken()
  */
 void haltestelle_t::remove_fabriken(fabrik_t *fab)
 {
+	next_link_generation();
 	fab_list.remove(fab);
 }
 
@@ -3052,6 +3217,7 @@ void haltestelle_t::add_ware_to_halt(ware_t ware, bool from_saved)
 		cargo[ware.get_desc()->get_catg_index()] = warray;
 	}
 	resort_freight_info = true;
+	wake_up();
 	if(!from_saved)
 	{
 		// the ware will be put into the first entry with menge==0
@@ -3077,6 +3243,7 @@ void haltestelle_t::add_to_waiting_list(ware_t ware, sint64 ready_time)
 	transferring_cargoes[0].append(tc);
 #endif
 	resort_freight_info = true;
+	wake_up();
 }
 
 sint64 haltestelle_t::calc_ready_time(ware_t ware, bool, koord origin_pos) const
@@ -3700,6 +3867,7 @@ void haltestelle_t::transfer_goods(halthandle_t halt)
 // private helper function for recalc_station_type()
 void haltestelle_t::add_to_station_type( grund_t *gr )
 {
+	next_link_generation();
 	// init in any case ...
 	if(  tiles.empty()  ) {
 		capacity[0] = 0;
@@ -3806,6 +3974,7 @@ void haltestelle_t::add_to_station_type( grund_t *gr )
  */
 void haltestelle_t::recalc_station_type()
 {
+	next_link_generation();
 	capacity[0] = 0;
 	capacity[1] = 0;
 	capacity[2] = 0;
@@ -5314,6 +5483,7 @@ bool haltestelle_t::add_grund(grund_t *gr, bool relink_factories, bool recalc_ne
 	add_to_station_type( gr );
 	gr->set_halt( self );
 	tiles.append( gr );
+	around_stats_step = -1;
 
 	// add to hashtable
 	if (all_koords) {
@@ -5434,6 +5604,7 @@ bool haltestelle_t::add_grund(grund_t *gr, bool relink_factories, bool recalc_ne
 	assert(gr->is_halt());
 
 	init_pos = tiles.front().grund->get_pos().get_2d();
+	next_link_generation();
 	if (recalc_nearby_halts)
 	{
 		check_nearby_halts();
@@ -5465,6 +5636,7 @@ bool haltestelle_t::rem_grund(grund_t *gr)
 		dbg->error("haltestelle_t::rem_grund()","removed illegal ground from halt");
 		return false;
 	}
+	around_stats_step = -1;
 
 	// first tile => remove name from this tile ...
 	char buf[256];
@@ -5482,6 +5654,7 @@ bool haltestelle_t::rem_grund(grund_t *gr)
 #endif
 	path_explorer_t::refresh_all_categories(false);
 	init_pos = tiles.empty() ? koord::invalid : tiles.front().grund->get_pos().get_2d();
+	next_link_generation();
 
 	// re-add name
 	if (station_name_to_transfer != NULL  &&  !tiles.empty()) {
@@ -5643,90 +5816,29 @@ void haltestelle_t::mark_unmark_coverage(const bool mark, const bool factories)
 }
 
 
-uint32 haltestelle_t::get_around_population(uint8 g_class) const
-{
-	uint32 sum = 0;
-	uint16 const cov = welt->get_settings().get_station_coverage();
-
-	koord ul(32767, 32767);
-	koord lr(0, 0);
-	FOR(slist_tpl<tile_t>, const& i, tiles) {
-		ul.clip_max(i.grund->get_pos().get_2d());
-		lr.clip_min(i.grund->get_pos().get_2d());
-	}
-
-	ul.x = max(0, ul.x - cov);
-	ul.y = max(0, ul.y - cov);
-	lr.x = min(welt->get_size().x, lr.x + 1 + cov);
-	lr.y = min(welt->get_size().y, lr.y + 1 + cov);
-	for (int y = ul.y; y < lr.y; y++) {
-		for (int x = ul.x; x < lr.x; x++) {
-			gebaeude_t* const gb = welt->access_nocheck(x, y)->get_kartenboden()->find<gebaeude_t>();
-			if (gb && gb == gb->get_first_tile()) {
-				sum += (g_class == 255) ? gb->get_adjusted_population() : gb->get_adjusted_population_by_class(g_class);
-			}
-		}
-	}
-	return sum;
-}
-
-uint32 haltestelle_t::get_around_visitor_demand(uint8 g_class) const
-{
-	uint32 sum = 0;
-	uint16 const cov = welt->get_settings().get_station_coverage();
-
-	koord ul(32767, 32767);
-	koord lr(0, 0);
-	FOR(slist_tpl<tile_t>, const& i, tiles) {
-		ul.clip_max(i.grund->get_pos().get_2d());
-		lr.clip_min(i.grund->get_pos().get_2d());
-	}
-
-	ul.x = max(0, ul.x - cov);
-	ul.y = max(0, ul.y - cov);
-	lr.x = min(welt->get_size().x, lr.x + 1 + cov);
-	lr.y = min(welt->get_size().y, lr.y + 1 + cov);
-	for (int y = ul.y; y < lr.y; y++) {
-		for (int x = ul.x; x < lr.x; x++) {
-			gebaeude_t* const gb = welt->access_nocheck(x, y)->get_kartenboden()->find<gebaeude_t>();
-			if (gb && gb == gb->get_first_tile()) {
-				sum += (g_class == 255) ? gb->get_adjusted_visitor_demand() : gb->get_adjusted_visitor_demand_by_class(g_class);
-			}
-		}
-	}
-	return sum;
-}
-
-uint32 haltestelle_t::get_around_job_demand(uint8 g_class) const
+const haltestelle_t::around_stats_t &haltestelle_t::get_around_stats() const
 {
-	uint32 sum = 0;
-	uint16 const cov = welt->get_settings().get_station_coverage();
-
-	koord ul(32767, 32767);
-	koord lr(0, 0);
-	FOR(slist_tpl<tile_t>, const& i, tiles) {
-		ul.clip_max(i.grund->get_pos().get_2d());
-		lr.clip_min(i.grund->get_pos().get_2d());
+	if(  around_stats_step == welt->get_steps()  &&  around_stats_generation == welt->get_building_list_generation()  ) {
+		return around_stats;
 	}
+	around_stats_step = welt->get_steps();
+	around_stats_generation = welt->get_building_list_generation();
 
-	ul.x = max(0, ul.x - cov);
-	ul.y = max(0, ul.y - cov);
-	lr.x = min(welt->get_size().x, lr.x + 1 + cov);
-	lr.y = min(welt->get_size().y, lr.y + 1 + cov);
-	for (int y = ul.y; y < lr.y; y++) {
-		for (int x = ul.x; x < lr.x; x++) {
-			gebaeude_t* const gb = welt->access_nocheck(x, y)->get_kartenboden()->find<gebaeude_t>();
-			if (gb && gb == gb->get_first_tile()) {
-				sum += (g_class == 255) ? gb->get_adjusted_jobs() : gb->get_adjusted_jobs_by_class(g_class);
-			}
-		}
+	const uint8 classes = goods_manager_t::passengers->get_number_of_classes();
+	around_stats_t &s = around_stats;
+	s.population.clear();
+	s.visitor_demand.clear();
+	s.job_demand.clear();
+	for(  uint8 i = 0;  i <= classes;  i++  ) {
+		s.population.append( 0 );
+		s.visitor_demand.append( 0 );
+		s.job_demand.append( 0 );
 	}
-	return sum;
-}
+	s.visitor_generated = s.succeeded_visiting = 0;
+	s.commuter_generated = s.succeeded_commuting = 0;
+	s.employee_factor = 0;
+	s.mail_demand = s.mail_generated = s.mail_delivery_succeeded = 0;
 
-uint32 haltestelle_t::get_around_visitor_generated() const
-{
-	uint32 sum = 0;
 	uint16 const cov = welt->get_settings().get_station_coverage();
 
 	koord ul(32767, 32767);
@@ -5744,203 +5856,50 @@ uint32 haltestelle_t::get_around_visitor_generated() const
 		for (int x = ul.x; x < lr.x; x++) {
 			gebaeude_t* const gb = welt->access_nocheck(x, y)->get_kartenboden()->find<gebaeude_t>();
 			if (gb && gb == gb->get_first_tile()) {
-				sum += gb->get_passengers_generated_visiting();
-			}
-		}
-	}
-	return sum;
-}
-
-uint32 haltestelle_t::get_around_succeeded_visiting() const
-{
-	uint32 sum = 0;
-	uint16 const cov = welt->get_settings().get_station_coverage();
-
-	koord ul(32767, 32767);
-	koord lr(0, 0);
-	FOR(slist_tpl<tile_t>, const& i, tiles) {
-		ul.clip_max(i.grund->get_pos().get_2d());
-		lr.clip_min(i.grund->get_pos().get_2d());
-	}
+				for(  uint8 i = 0;  i < classes;  i++  ) {
+					s.population[i] += gb->get_adjusted_population_by_class(i);
+					s.visitor_demand[i] += gb->get_adjusted_visitor_demand_by_class(i);
+					s.job_demand[i] += gb->get_adjusted_jobs_by_class(i);
+				}
+				s.population[classes] += gb->get_adjusted_population();
+				s.visitor_demand[classes] += gb->get_adjusted_visitor_demand();
+				s.job_demand[classes] += gb->get_adjusted_jobs();
 
-	ul.x = max(0, ul.x - cov);
-	ul.y = max(0, ul.y - cov);
-	lr.x = min(welt->get_size().x, lr.x + 1 + cov);
-	lr.y = min(welt->get_size().y, lr.y + 1 + cov);
-	for (int y = ul.y; y < lr.y; y++) {
-		for (int x = ul.x; x < lr.x; x++) {
-			gebaeude_t* const gb = welt->access_nocheck(x, y)->get_kartenboden()->find<gebaeude_t>();
-			if (gb && gb == gb->get_first_tile()) {
 				// Must not exceed 100%! That is, the number of successes <= the number of generations must be, in any buildings
-				sum += min(gb->get_passengers_succeeded_visiting(), gb->get_passengers_generated_visiting());
-			}
-		}
-	}
-	return sum;
-}
+				s.visitor_generated += gb->get_passengers_generated_visiting();
+				s.succeeded_visiting += min(gb->get_passengers_succeeded_visiting(), gb->get_passengers_generated_visiting());
+				s.commuter_generated += gb->get_passengers_generated_commuting();
+				s.succeeded_commuting += min(gb->get_passengers_succeeded_commuting(), gb->get_passengers_generated_commuting());
+				s.employee_factor += gb->get_adjusted_jobs() - max(gb->check_remaining_available_jobs(),0);
 
-uint32 haltestelle_t::get_around_commuter_generated() const
-{
-	uint32 sum = 0;
-	uint16 const cov = welt->get_settings().get_station_coverage();
-
-	koord ul(32767, 32767);
-	koord lr(0, 0);
-	FOR(slist_tpl<tile_t>, const& i, tiles) {
-		ul.clip_max(i.grund->get_pos().get_2d());
-		lr.clip_min(i.grund->get_pos().get_2d());
-	}
-
-	ul.x = max(0, ul.x - cov);
-	ul.y = max(0, ul.y - cov);
-	lr.x = min(welt->get_size().x, lr.x + 1 + cov);
-	lr.y = min(welt->get_size().y, lr.y + 1 + cov);
-	for (int y = ul.y; y < lr.y; y++) {
-		for (int x = ul.x; x < lr.x; x++) {
-			gebaeude_t* const gb = welt->access_nocheck(x, y)->get_kartenboden()->find<gebaeude_t>();
-			if (gb && gb == gb->get_first_tile()) {
-				sum += gb->get_passengers_generated_commuting();
+				s.mail_demand += gb->get_adjusted_mail_demand();
+				s.mail_generated += gb->get_mail_generated();
+				s.mail_delivery_succeeded += min(gb->get_mail_delivery_succeeded(), gb->get_mail_generated());
 			}
 		}
 	}
-	return sum;
+	return around_stats;
 }
 
-uint32 haltestelle_t::get_around_succeeded_commuting() const
-{
-	uint32 sum = 0;
-	uint16 const cov = welt->get_settings().get_station_coverage();
-
-	koord ul(32767, 32767);
-	koord lr(0, 0);
-	FOR(slist_tpl<tile_t>, const& i, tiles) {
-		ul.clip_max(i.grund->get_pos().get_2d());
-		lr.clip_min(i.grund->get_pos().get_2d());
-	}
-
-	ul.x = max(0, ul.x - cov);
-	ul.y = max(0, ul.y - cov);
-	lr.x = min(welt->get_size().x, lr.x + 1 + cov);
-	lr.y = min(welt->get_size().y, lr.y + 1 + cov);
-	for (int y = ul.y; y < lr.y; y++) {
-		for (int x = ul.x; x < lr.x; x++) {
-			gebaeude_t* const gb = welt->access_nocheck(x, y)->get_kartenboden()->find<gebaeude_t>();
-			if (gb && gb == gb->get_first_tile()) {
-				// Must not exceed 100%! That is, the number of successes <= the number of generations must be, in any buildings
-				sum += min(gb->get_passengers_succeeded_commuting(), gb->get_passengers_generated_commuting());
-			}
-		}
-	}
-	return sum;
-}
 
-uint32 haltestelle_t::get_around_employee_factor() const
+uint32 haltestelle_t::get_around_population(uint8 g_class) const
 {
-	uint32 sum = 0;
-	uint16 const cov = welt->get_settings().get_station_coverage();
-
-	koord ul(32767, 32767);
-	koord lr(0, 0);
-	FOR(slist_tpl<tile_t>, const& i, tiles) {
-		ul.clip_max(i.grund->get_pos().get_2d());
-		lr.clip_min(i.grund->get_pos().get_2d());
-	}
-
-	ul.x = max(0, ul.x - cov);
-	ul.y = max(0, ul.y - cov);
-	lr.x = min(welt->get_size().x, lr.x + 1 + cov);
-	lr.y = min(welt->get_size().y, lr.y + 1 + cov);
-	for (int y = ul.y; y < lr.y; y++) {
-		for (int x = ul.x; x < lr.x; x++) {
-			gebaeude_t* const gb = welt->access_nocheck(x, y)->get_kartenboden()->find<gebaeude_t>();
-			if (gb && gb == gb->get_first_tile()) {
-				sum += gb->get_adjusted_jobs() - max(gb->check_remaining_available_jobs(),0);
-			}
-		}
-	}
-	return sum;
+	const around_stats_t &s = get_around_stats();
+	return s.population[ min( (uint32)g_class, s.population.get_count()-1 ) ];
 }
 
-uint32 haltestelle_t::get_around_mail_demand() const
-{
-	uint32 sum = 0;
-	uint16 const cov = welt->get_settings().get_station_coverage();
-
-	koord ul(32767, 32767);
-	koord lr(0, 0);
-	FOR(slist_tpl<tile_t>, const& i, tiles) {
-		ul.clip_max(i.grund->get_pos().get_2d());
-		lr.clip_min(i.grund->get_pos().get_2d());
-	}
-
-	ul.x = max(0, ul.x - cov);
-	ul.y = max(0, ul.y - cov);
-	lr.x = min(welt->get_size().x, lr.x + 1 + cov);
-	lr.y = min(welt->get_size().y, lr.y + 1 + cov);
-	for (int y = ul.y; y < lr.y; y++) {
-		for (int x = ul.x; x < lr.x; x++) {
-			gebaeude_t* const gb = welt->access_nocheck(x, y)->get_kartenboden()->find<gebaeude_t>();
-			if (gb && gb == gb->get_first_tile()) {
-				sum += gb->get_adjusted_mail_demand();
-			}
-		}
-	}
-	return sum;
-}
 
-uint32 haltestelle_t::get_around_mail_generated() const
+uint32 haltestelle_t::get_around_visitor_demand(uint8 g_class) const
 {
-	uint32 sum = 0;
-	uint16 const cov = welt->get_settings().get_station_coverage();
-
-	koord ul(32767, 32767);
-	koord lr(0, 0);
-	FOR(slist_tpl<tile_t>, const& i, tiles) {
-		ul.clip_max(i.grund->get_pos().get_2d());
-		lr.clip_min(i.grund->get_pos().get_2d());
-	}
-
-	ul.x = max(0, ul.x - cov);
-	ul.y = max(0, ul.y - cov);
-	lr.x = min(welt->get_size().x, lr.x + 1 + cov);
-	lr.y = min(welt->get_size().y, lr.y + 1 + cov);
-	for (int y = ul.y; y < lr.y; y++) {
-		for (int x = ul.x; x < lr.x; x++) {
-			gebaeude_t* const gb = welt->access_nocheck(x, y)->get_kartenboden()->find<gebaeude_t>();
-			if (gb && gb == gb->get_first_tile()) {
-				sum += gb->get_mail_generated();
-			}
-		}
-	}
-	return sum;
+	const around_stats_t &s = get_around_stats();
+	return s.visitor_demand[ min( (uint32)g_class, s.visitor_demand.get_count()-1 ) ];
 }
 
-uint32 haltestelle_t::get_around_mail_delivery_succeeded() const
-{
-	uint32 sum = 0;
-	uint16 const cov = welt->get_settings().get_station_coverage();
-
-	koord ul(32767, 32767);
-	koord lr(0, 0);
-	FOR(slist_tpl<tile_t>, const& i, tiles) {
-		ul.clip_max(i.grund->get_pos().get_2d());
-		lr.clip_min(i.grund->get_pos().get_2d());
-	}
 
-	ul.x = max(0, ul.x - cov);
-	ul.y = max(0, ul.y - cov);
-	lr.x = min(welt->get_size().x, lr.x + 1 + cov);
-	lr.y = min(welt->get_size().y, lr.y + 1 + cov);
-	for (int y = ul.y; y < lr.y; y++) {
-		for (int x = ul.x; x < lr.x; x++) {
-			gebaeude_t* const gb = welt->access_nocheck(x, y)->get_kartenboden()->find<gebaeude_t>();
-			if (gb && gb == gb->get_first_tile()) {
-				// Must not exceed 100%! That is, the number of successes <= the number of generations must be, in any buildings
-				sum += min(gb->get_mail_delivery_succeeded(), gb->get_mail_generated());
-			}
-		}
-	}
-	return sum;
+uint32 haltestelle_t::get_around_job_demand(uint8 g_class) const
+{
+	const around_stats_t &s = get_around_stats();
+	return s.job_demand[ min( (uint32)g_class, s.job_demand.get_count()-1 ) ];
 }
 
 
@@ -6149,6 +6108,7 @@ void haltestelle_t::connexion::operator delete(void *p)
 */
 void haltestelle_t::release_factory_links()
 {
+	next_link_generation();
 	fab_list.clear();
 }
 
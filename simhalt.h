@@ -209,6 +209,20 @@ private:
 	*/
 	vector_tpl<transferring_cargo_t> *transferring_cargoes;
 
+	/**
+	* Halts without waiting cargo and nothing to re-route sleep:
+	* step_all() skips them until cargo arrives (wake_up())
+	* or their alarm, e.g. for the next ready transfer, is due.
+	*/
+	bool awake;
+	sint64 alarm_time;
+
+	/// true if step() has nothing to do until the next transfer is ready
+	bool is_idle() const;
+
+	/// takes this halt out of step_all() until the next relevant time
+	void fall_asleep();
+
 public:
 	const slist_tpl<convoihandle_t> &get_loading_convois() const { return loading_here; }
 
@@ -220,9 +234,18 @@ public:
 
 	/**
 	 * Handles changes of schedules and the resulting re-routing.
+	 * Only steps the halts which are awake or whose alarm is due,
+	 * each as often as when all halts were stepped in turn.
 	 */
 	static void step_all();
 
+	/**
+	 * Wakes up all halts, in the order of a freshly loaded game.
+	 * The sleep state is not saved, so all peers call this at the sync step
+	 * where a joining client gets its snapshot (karte_t::reset_unsaved_state()).
+	 */
+	static void reset_sleep_state();
+
 	/**
 	 * Resets reconnect_counter.
 	 * The next call to step_all() will start complete reconnecting.
@@ -370,6 +393,30 @@ public:
 private:
 	slist_tpl<tile_t> tiles;
 
+	/// sums over the buildings in the coverage area, for the get_around_...() functions
+	struct around_stats_t
+	{
+		vector_tpl<uint32> population;     ///< by class, total at the end
+		vector_tpl<uint32> visitor_demand; ///< by class, total at the end
+		vector_tpl<uint32> job_demand;     ///< by class, total at the end
+		uint32 visitor_generated;
+		uint32 succeeded_visiting;
+		uint32 commuter_generated;
+		uint32 succeeded_commuting;
+		uint32 employee_factor;
+		uint32 mail_demand;
+		uint32 mail_generated;
+		uint32 mail_delivery_succeeded;
+	};
+	mutable around_stats_t around_stats;
+
+	/// world step and building list generation of around_stats; step -1 if invalid
+	mutable sint32 around_stats_step;
+	mutable uint32 around_stats_generation;
+
+	/// collects around_stats in one pass unless they are still valid
+	const around_stats_t &get_around_stats() const;
+
 	// Table of all direct connexions to this halt, with routing information.
 	// One entry per goods type and class.
 	// This stores pointers to connexions_map objects to enable quick swapping.
@@ -415,6 +462,9 @@ private:
 	 */
 	static uint8 reconnect_counter;
 
+	/// see get_link_generation()
+	static uint32 link_generation;
+
 	// since we do partial routing, we remember the last offset
 	uint8 last_catg_index;
 	uint32 last_goods_index;
@@ -603,6 +653,14 @@ public:
 	void get_destination_halts_of_ware(ware_t &ware, vector_tpl<halthandle_t>& destination_halts_list) const;
 	uint32 find_route(const vector_tpl<halthandle_t>& ziel_list, ware_t & ware, const uint32 journey_time = UINT32_MAX_VALUE, const koord destination_pos = koord::invalid) const;
 
+	/**
+	 * Changes whenever a halt is added to or removed from the halt list of a tile,
+	 * the factories of a halt or its enabled goods change or it moves,
+	 * so the destination halts of goods may be cached as long as it stays the same.
+	 */
+	static uint32 get_link_generation() { return link_generation; }
+	static void next_link_generation() { link_generation++; }
+
 	inline bool get_pax_enabled()  const { return enables & PAX;  }
 	inline bool get_mail_enabled() const { return enables & POST; }
 	inline bool get_ware_enabled() const { return enables & WARE; }
@@ -874,20 +932,21 @@ public:
 	/* marks a coverage area */
 	void mark_unmark_coverage(const bool mark, const bool factories = false) const;
 
+	// These are summed up once per step (or after buildings or tiles changed) for all of them.
 	uint32 get_around_population(uint8 g_class = 255) const;
 	uint32 get_around_visitor_demand(uint8 g_class = 255) const;
 	uint32 get_around_job_demand(uint8 g_class = 255) const;
 
-	uint32 get_around_visitor_generated() const;
-	uint32 get_around_succeeded_visiting() const;
-	uint32 get_around_commuter_generated() const;
-	uint32 get_around_succeeded_commuting() const;
+	uint32 get_around_visitor_generated() const { return get_around_stats().visitor_generated; }
+	uint32 get_around_succeeded_visiting() const { return get_around_stats().succeeded_visiting; }
+	uint32 get_around_commuter_generated() const { return get_around_stats().commuter_generated; }
+	uint32 get_around_succeeded_commuting() const { return get_around_stats().succeeded_commuting; }
 	// Returns the current number of workers, but overflows are truncated per building.
-	uint32 get_around_employee_factor() const;
+	uint32 get_around_employee_factor() const { return get_around_stats().employee_factor; }
 
-	uint32 get_around_mail_demand() const;
-	uint32 get_around_mail_generated() const;
-	uint32 get_around_mail_delivery_succeeded() const;
+	uint32 get_around_mail_demand() const { return get_around_stats().mail_demand; }
+	uint32 get_around_mail_generated() const { return get_around_stats().mail_generated; }
+	uint32 get_around_mail_delivery_succeeded() const { return get_around_stats().mail_delivery_succeeded; }
 
 	// The number of passengers who have tried to use this station.
 	sint64 get_potential_passenger_number(uint8 month) const
@@ -963,7 +1022,10 @@ public:
 	*/
 	inline uint32 get_transshipment_time() const { return transshipment_time; }
 
-	void set_reroute_goods_next_step(uint8 catg) { categories_to_refresh_next_step.append(catg); }
+	void set_reroute_goods_next_step(uint8 catg) { categories_to_refresh_next_step.append(catg); wake_up(); }
+
+	/// makes step_all() step this halt again; may be called from other threads
+	void wake_up();
 
 	/**
 	* Calculate the transfer and transshipment time values.
@@ -800,6 +800,7 @@ void planquadrat_t::add_to_haltlist(halthandle_t halt)
 {
 	if(halt.is_bound())
 	{
+		haltestelle_t::next_link_generation();
 		// Quick and dirty way to our 2d co-ordinates
 		const koord pos = get_kartenboden()->get_pos().get_2d();
 		const koord halt_next_pos = halt->get_next_pos(pos, true);
@@ -832,6 +833,7 @@ void planquadrat_t::add_to_haltlist(halthandle_t halt)
  */
 void planquadrat_t::remove_from_haltlist(halthandle_t halt)
 {
+	haltestelle_t::next_link_generation();
 	halt_list_remove(halt);
 
 	// We might still be connected (to a different tile on the halt, in which case reconnect.
@@ -320,6 +320,84 @@ void karte_t::world_xy_loop(xy_loop_func function, uint8 flags)
 }
 
 
+void karte_t::world_index_loop(index_loop_func function, uint32 count)
+{
+	index_loop_function = function;
+	index_loop_count = count;
+	world_xy_loop( &karte_t::world_index_loop_xy, 0 );
+}
+
+
+void karte_t::world_index_loop(index_loop_callback func, void *data, uint32 count)
+{
+	index_loop_callback_function = func;
+	index_loop_callback_data = data;
+	world_index_loop( &karte_t::world_index_loop_callback, count );
+}
+
+
+void karte_t::world_index_loop_callback(uint32 first, uint32 last)
+{
+	index_loop_callback_function( index_loop_callback_data, first, last );
+}
+
+
+void karte_t::world_index_loop_xy(sint16, sint16, sint16 y_min, sint16 y_max)
+{
+	// map the rows of this thread to the same share of the indices
+	const uint64 max_y = cached_grid_size.y > 0 ? cached_grid_size.y : 1;
+	const uint32 first = (uint32)( ((uint64)y_min * index_loop_count) / max_y );
+	const uint32 last = (uint32)( ((uint64)y_max * index_loop_count) / max_y );
+	if(  first < last  ) {
+		(this->*index_loop_function)( first, last );
+	}
+}
+
+
+void karte_t::step_factories_production(uint32 first, uint32 last)
+{
+	for(  uint32 i = first;  i < last;  i++  ) {
+		fab_list[i]->step_production( factory_step_delta_t );
+	}
+}
+
+
+#ifdef MULTI_THREAD
+static pthread_mutex_t worn_out_ways_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+void karte_t::new_month_ways(uint32 first, uint32 last)
+{
+	const vector_tpl<weg_t *> &ways = weg_t::get_alle_wege();
+	vector_tpl<uint32> worn_out;
+	for(  uint32 i = first;  i < last;  i++  ) {
+		if(  ways[i]->new_month_wear()  ) {
+			worn_out.append( i );
+		}
+	}
+	if(  !worn_out.empty()  ) {
+#ifdef MULTI_THREAD
+		pthread_mutex_lock( &worn_out_ways_mutex );
+#endif
+		FOR(vector_tpl<uint32>, const i, worn_out) {
+			worn_out_ways.append( i );
+		}
+#ifdef MULTI_THREAD
+		pthread_mutex_unlock( &worn_out_ways_mutex );
+#endif
+	}
+}
+
+
+void karte_t::check_worn_out_ways_in_city(uint32 first, uint32 last)
+{
+	const vector_tpl<weg_t *> &ways = weg_t::get_alle_wege();
+	for(  uint32 i = first;  i < last;  i++  ) {
+		worn_out_ways_in_city[i] = ways[ worn_out_ways[i] ]->is_in_city();
+	}
+}
+
+
 void karte_t::recalc_season_snowline(bool set_pending)
 {
 	static const sint8 mfactor[12] = { 99, 95, 80, 50, 25, 10, 0, 5, 20, 35, 65, 85 };
@@ -503,6 +581,8 @@ void karte_t::destroy()
 		visitor_targets[i].clear();
 	}
 
+	factory_grid.clear();
+
 	uint32 max_display_progress = 256+stadt.get_count()*10 + haltestelle_t::get_alle_haltestellen().get_count() + convoi_array.get_count() + (cached_size.x*cached_size.y)*2;
 	uint32 old_progress = 0;
 
@@ -2692,6 +2772,7 @@ void karte_t::enlarge_map(settings_t const* sets, sint8 const* const h_field)
 	cached_size_max = max(cached_grid_size.x,cached_grid_size.y);
 	cached_size.x = cached_grid_size.x-1;
 	cached_size.y = cached_grid_size.y-1;
+	rebuild_factory_grid();
 
 	intr_disable();
 
@@ -3036,6 +3117,7 @@ karte_t::karte_t() :
 	speed_factors_are_set(false)
 {
 	destroying = false;
+	building_list_generation = 0;
 
 	// length of day and other time stuff
 	ticks_per_world_month_shift = 20;
@@ -4109,6 +4191,20 @@ void karte_t::rdwr_player_password_hashes(loadsave_t *file)
 }
 
 
+void karte_t::reset_unsaved_state()
+{
+	await_path_explorer();
+	// as at the end of load()
+	if(  !get_settings().get_save_path_explorer_data()  ) {
+		path_explorer_t::full_instant_refresh();
+	}
+	FOR(weighted_vector_tpl<gebaeude_t*>, const &i, world_attractions) {
+		i->check_road_tiles(false);
+	}
+	haltestelle_t::reset_sleep_state();
+}
+
+
 void karte_t::call_change_player_tool(uint8 cmd, uint8 player_nr, uint16 param, bool scripted_call)
 {
 	if (env_t::networkmode) {
@@ -4496,6 +4592,7 @@ DBG_MESSAGE( "karte_t::rotate90()", "called" );
 	FOR(vector_tpl<fabrik_t*>, const f, fab_list) {
 		f->rotate90(cached_size.x);
 	}
+	rebuild_factory_grid();
 	// after rotation of factories, rotate everything that holds freight: stations and convoys
 	FOR(vector_tpl<halthandle_t>, const s, haltestelle_t::get_alle_haltestellen()) {
 		s->rotate90(cached_size.x);
@@ -4610,6 +4707,7 @@ bool karte_t::add_fab(fabrik_t *fab)
 	assert(fab != NULL);
 	//fab_list.insert( fab );
 	fab_list.append(fab);
+	factory_grid.add( fab, fab->get_pos().get_2d(), fab->get_desc()->get_building()->get_size(fab->get_rotate()) );
 	goods_in_game.clear(); // Force rebuild of goods list
 	return true;
 }
@@ -4625,6 +4723,7 @@ bool karte_t::rem_fab(fabrik_t *fab)
 	else
 	{
 		fab_list.remove(fab);
+		factory_grid.remove( fab, fab->get_pos().get_2d() );
 	}
 
 	// Force rebuild of goods list
@@ -4669,6 +4768,15 @@ bool karte_t::rem_fab(fabrik_t *fab)
 	return true;
 }
 
+void karte_t::rebuild_factory_grid()
+{
+	factory_grid.init( get_size() );
+	FOR(vector_tpl<fabrik_t*>, const fab, fab_list) {
+		factory_grid.add( fab, fab->get_pos().get_2d(), fab->get_desc()->get_building()->get_size(fab->get_rotate()) );
+	}
+}
+
+
 void karte_t::fab_init_contracts(){
 	for(fabrik_t* fab : fab_list){
 		fab->init_contracts();
@@ -5134,8 +5242,20 @@ void karte_t::new_month()
 
 	// this should be done before a map update, since the map may want an update of the way usage
 //	DBG_MESSAGE("karte_t::new_month()","ways");
-	FOR(vector_tpl<weg_t*>, const w, weg_t::get_alle_wege()) {
-		w->new_month();
+	// the statistics of all ways roll at once; wear in parallel, then renew or degrade the worn out ways in list order
+	weg_t::new_statistics_month();
+	worn_out_ways.clear();
+	world_index_loop( &karte_t::new_month_ways, weg_t::get_alle_wege().get_count() );
+	std::sort( worn_out_ways.begin(), worn_out_ways.end() );
+	worn_out_ways_in_city.clear();
+	worn_out_ways_in_city.resize( worn_out_ways.get_count() );
+	for(  uint32 i = 0;  i < worn_out_ways.get_count();  i++  ) {
+		worn_out_ways_in_city.append( false );
+	}
+	world_index_loop( &karte_t::check_worn_out_ways_in_city, worn_out_ways.get_count() );
+	// the renewals are booked one after the other, as each checks whether the owner can still afford it
+	for(  uint32 i = 0;  i < worn_out_ways.get_count();  i++  ) {
+		weg_t::get_alle_wege()[ worn_out_ways[i] ]->renew_or_degrade( worn_out_ways_in_city[i] );
 	}
 
 	// Update the maximum vehicle speed records to calibrate when passengers should not burden the journey time database.
@@ -5341,11 +5461,19 @@ void karte_t::new_month()
 	tool_t::update_toolbars();
 
 
-	// no autosave in networkmode or when the new world dialogue is shown
-	if( !env_t::networkmode && env_t::autosave>0 && last_month%env_t::autosave==0 && !win_get_magic(magic_welt_gui_t) ) {
+	// no autosave when the new world dialogue is shown
+	// in networkmode only the server saves, and only from a forked copy, which cannot disturb the game
+	if( env_t::autosave>0 && last_month%env_t::autosave==0 && !win_get_magic(magic_welt_gui_t) ) {
 		char buf[128];
 		sprintf( buf, "save/autosave%02i.sve", last_month+1 );
-		save( buf, true, env_t::savegame_version_str, env_t::savegame_ex_version_str, env_t::savegame_ex_revision_str, true );
+		if(  !env_t::networkmode  ) {
+			if(  !env_t::autosave_in_background  ||  !save_in_background( buf, env_t::savegame_version_str, env_t::savegame_ex_version_str, env_t::savegame_ex_revision_str )  ) {
+				save( buf, true, env_t::savegame_version_str, env_t::savegame_ex_version_str, env_t::savegame_ex_revision_str, true );
+			}
+		}
+		else if(  env_t::server  &&  env_t::autosave_in_background  ) {
+			save_in_background( buf, env_t::savegame_version_str, env_t::savegame_ex_version_str, env_t::savegame_ex_revision_str );
+		}
 	}
 
 	recalc_passenger_destination_weights();
@@ -5995,8 +6123,12 @@ void karte_t::step()
 	INT_CHECK("karte_t::step 5");
 
 	DBG_DEBUG4("karte_t::step", "step factories");
+	// production only touches the factory itself and runs in parallel,
+	// the goods are then distributed serially in the order of fab_list
+	factory_step_delta_t = delta_t;
+	world_index_loop( &karte_t::step_factories_production, fab_list.get_count() );
 	FOR(vector_tpl<fabrik_t*>, const f, fab_list) {
-		f->step(delta_t);
+		f->step_distribution(delta_t);
 	}
 	rands[20] = get_random_seed();
 
@@ -8448,7 +8580,7 @@ bool karte_t::play_sound_area_clipped(koord const k, uint16 const idx, sound_typ
 }
 
 
-void karte_t::save(const char *filename, bool autosave, const char *version_str, const char *ex_version_str, const char* ex_revision_str, bool silent )
+void karte_t::save(const char *filename, bool autosave, const char *version_str, const char *ex_version_str, const char* ex_revision_str, bool silent, rdwr_stream_t *tee, const char *delta_base )
 {
 DBG_MESSAGE("karte_t::save()", "saving game to '%s'", filename);
 	loadsave_t  file;
@@ -8466,7 +8598,7 @@ DBG_MESSAGE("karte_t::save()", "saving game to '%s'", filename);
 
 	const loadsave_t::mode_t mode = autosave ? loadsave_t::autosave_mode : loadsave_t::save_mode;
 	const int level = autosave ? loadsave_t::autosave_level : loadsave_t::save_level;
-	loadsave_t::file_status_t status = file.wr_open( savename.c_str(), mode, level, env_t::objfilename.c_str(), version_str, ex_version_str, ex_revision_str );
+	loadsave_t::file_status_t status = file.wr_open( savename.c_str(), mode, level, env_t::objfilename.c_str(), version_str, ex_version_str, ex_revision_str, tee, delta_base );
 
 	if(status != loadsave_t::FILE_STATUS_OK) {
 		create_win(new news_img("Kann Spielstand\nnicht speichern.\n"), w_info, magic_none);
@@ -8501,6 +8633,70 @@ DBG_MESSAGE("karte_t::save()", "saving game to '%s'", filename);
 }
 
 
+// true in the forked process of save_in_background()
+static bool is_background_save_child = false;
+static int background_save_pid = -1;
+static std::string background_save_name;
+
+bool karte_t::save_in_background(const char *filename, const char *version_str, const char *ex_version_str, const char* ex_revision_str)
+{
+	check_background_save();
+	if(  background_save_pid > 0  ) {
+		dbg->warning( "karte_t::save_in_background()", "previous save still running, skipping '%s'", filename );
+		return true;
+	}
+	if(  nosave_warning  ) {
+		// rotating the map needs the worker threads, which do not exist in the child
+		return false;
+	}
+	// park the worker threads, so the copy contains no half done step
+	await_all_threads();
+
+	const int pid = dr_fork();
+	if(  pid < 0  ) {
+		return false;
+	}
+	if(  pid == 0  ) {
+		// child: only this thread was copied, so neither the worker threads nor the display may be used,
+		// and no new threads may be started (the copied mutexes may be locked forever)
+		is_background_save_child = true;
+		loadsave_t::set_single_threaded( true );
+		env_t::num_threads = 1;
+		std::string savename = filename;
+		savename[savename.length() - 1] = '_';
+		int status = 1;
+		loadsave_t file;
+		if(  file.wr_open( savename.c_str(), loadsave_t::autosave_mode, loadsave_t::autosave_level, env_t::objfilename.c_str(), version_str, ex_version_str, ex_revision_str ) == loadsave_t::FILE_STATUS_OK  ) {
+			save( &file, true );
+			if(  file.close() == NULL  &&  dr_rename( savename.c_str(), filename ) == 0  ) {
+				status = 0;
+			}
+		}
+		dr_exit_child( status );
+	}
+	background_save_pid = pid;
+	background_save_name = filename;
+	DBG_MESSAGE( "karte_t::save_in_background()", "saving game to '%s' in process %d", filename, pid );
+	return true;
+}
+
+
+void karte_t::check_background_save()
+{
+	bool failed = false;
+	if(  background_save_pid <= 0  ||  dr_child_running( background_save_pid, &failed )  ) {
+		return;
+	}
+	background_save_pid = -1;
+	if(  failed  ) {
+		dbg->warning( "karte_t::check_background_save()", "saving '%s' in the background failed", background_save_name.c_str() );
+		cbuffer_t buf;
+		buf.printf( translator::translate("Could not save %s"), background_save_name.c_str() );
+		msg->add_message( buf, koord::invalid, message_t::general, color_idx_to_rgb(COL_RED) );
+	}
+}
+
+
 void karte_t::save(loadsave_t *file, bool silent)
 {
 	bool needs_redraw = false;
@@ -8511,7 +8707,9 @@ DBG_MESSAGE("karte_t::save(loadsave_t *file)", "start");
 		ls = new loadingscreen_t( translator::translate("Saving map ..."), get_size().y );
 	}
 #ifdef MULTI_THREAD
-	await_all_threads();
+	if(  !is_background_save_child  ) {
+		await_all_threads();
+	}
 #endif
 	// rotate the map until it can be saved completely
 	for( int i=0;  i<4  &&  nosave_warning;  i++  ) {
@@ -9283,6 +9481,7 @@ void karte_t::rdwr_gamestate(loadsave_t *file, loadingscreen_t *ls)
 				ls->set_progress( get_size().y/2+(128*i)/fabs );
 			}
 		}
+		rebuild_factory_grid();
 	}
 	else {
 		sint32 fabs = fab_list.get_count();
@@ -11276,6 +11475,10 @@ void karte_t::do_network_world_command(network_world_command_t *nwc)
 		if(client_checklist != server_checklist)
 		{
 			network_disconnect();
+			const uint8 subsystem = client_checklist.get_mismatched_subsystem(server_checklist);
+			if(  subsystem < CHK_SUBSYSTEMS  ) {
+				dbg->warning("karte_t:::do_network_world_command", "Game state of %s differs from server", checklist_t::subsystem_names[subsystem] );
+			}
 			// output warning / throw fatal error depending on heavy mode setting
 			void (log_t::*outfn)(const char*, const char*, ...) = (env_t::network_heavy_mode == 2 ? &log_t::fatal : &log_t::warning);
 			(dbg->*outfn)("karte_t:::do_network_world_command", "Disconnected due to checklist mismatch" );
@@ -11341,14 +11544,22 @@ static void heavy_rotate_saves(const char *prefix, uint32 sync_steps, uint32 num
 {
 	dr_mkdir( SAVE_PATH_X "heavy");
 
-	cbuffer_t name;
+	// a full save every num_to_keep steps, in between only the differences to it
+	const uint32 base_step = sync_steps - sync_steps % num_to_keep;
+	cbuffer_t name, base_name;
 	name.printf(SAVE_PATH_X "heavy/heavy-%s-%04d.sve", prefix, sync_steps);
-	world()->save(name, false, SERVER_SAVEGAME_VER_NR, EXTENDED_VER_NR, EXTENDED_REVISION_NR, true);
+	base_name.printf(SAVE_PATH_X "heavy/heavy-%s-%04d.sve", prefix, base_step);
+	file_info_t info;
+	const bool delta = base_step != sync_steps  &&  classify_file(base_name, &info) == FILE_CLASSIFY_OK;
+	world()->save(name, false, SERVER_SAVEGAME_VER_NR, EXTENDED_VER_NR, EXTENDED_REVISION_NR, true, NULL, delta ? base_name.get_str() : NULL);
 
-	if (sync_steps >= num_to_keep) {
-		cbuffer_t old_name;
-		old_name.printf(SAVE_PATH_X "heavy/heavy-%s-%04d.sve", prefix, sync_steps - num_to_keep);
-		dr_remove(old_name);
+	// when a new base was written, remove the chain before the previous one
+	if(  sync_steps == base_step  &&  sync_steps >= 2*num_to_keep  ) {
+		for(  uint32 i = sync_steps - 2*num_to_keep;  i < sync_steps - num_to_keep;  i++  ) {
+			cbuffer_t old_name;
+			old_name.printf(SAVE_PATH_X "heavy/heavy-%s-%04d.sve", prefix, i);
+			dr_remove(old_name);
+		}
 	}
 }
 
@@ -11416,6 +11627,8 @@ bool karte_t::interactive(uint32 quit_month)
 			break;
 		}
 
+		check_background_save();
+
 		if(  env_t::networkmode  ) {
 			process_network_commands(&ms_difference);
 
@@ -11504,11 +11717,24 @@ bool karte_t::interactive(uint32 quit_month)
 								rands, debug_sums
 							);
 							break;
-						case 2:
+						case 1: {
+							// one part per sync step, in turn, so a step costs far less than hashing the whole game;
+							// the checks (every server_sync_steps_between_checks) see the next part each time
+							uint32 subsystem_hashes[CHK_SUBSYSTEMS] = {};
+							const uint32 between_checks = env_t::server_sync_steps_between_checks;
+							const uint8 subsystem = (sync_steps / between_checks + sync_steps % between_checks) % CHK_SUBSYSTEMS;
+							subsystem_hashes[subsystem] = get_gamestate_hash(subsystem);
+							LCHKLST(sync_steps) = checklist_t(0, subsystem_hashes);
+							break;
+						}
+						case 2: {
 							heavy_rotate_saves(env_t::server ? "server" : "client", sync_steps, 10);
-							// fall-through
-						case 1:
-							LCHKLST(sync_steps) = checklist_t(get_gamestate_hash());
+							uint32 subsystem_hashes[CHK_SUBSYSTEMS];
+							for(  uint8 i = 0;  i < CHK_SUBSYSTEMS;  i++  ) {
+								subsystem_hashes[i] = get_gamestate_hash(i);
+							}
+							LCHKLST(sync_steps) = checklist_t(0, subsystem_hashes);
+						}
 					}
 
 					// some server side tasks
@@ -11858,6 +12084,7 @@ void karte_t::add_building_to_world_list(gebaeude_t *gb, bool ordered)
 	{
 		return;
 	}
+	building_list_generation++;
 	const building_desc_t *building = gb->get_tile()->get_desc();
 
 	if (building->get_mail_demand_and_production_capacity() == 0 && building->get_population_and_visitor_demand_capacity() == 0 && building->get_employment_capacity() == 0)
@@ -11971,6 +12198,8 @@ void karte_t::remove_building_from_world_list(gebaeude_t *gb)
 		return;
 	}
 
+	building_list_generation++;
+
 	// We do not need to specify the type here, as we can try removing from all lists.
 	passenger_origins.remove_all(gb);
 	for (uint8 i = 0; i < goods_manager_t::passengers->get_number_of_classes(); i++)
@@ -11995,6 +12224,7 @@ void karte_t::update_weight_of_building_in_world_list(gebaeude_t *gb)
 		// this is called from a field of a factory that is closing down.
 		return;
 	}
+	building_list_generation++;
 
 	if(passenger_origins.update(gb, gb->get_adjusted_population())){
 		passenger_step_interval = calc_adjusted_step_interval(passenger_origins.get_sum_weight(), get_settings().get_passenger_trips_per_month_hundredths());
@@ -12610,3 +12840,52 @@ uint32 karte_t::get_gamestate_hash()
 	rdwr_gamestate(&ls, NULL);
 	return stream->get_hash();
 }
+
+
+uint32 karte_t::get_gamestate_hash(uint8 subsystem)
+{
+	adler32_stream_t *stream = new adler32_stream_t;
+	stream_loadsave_t ls(stream);
+
+	switch(  subsystem  ) {
+		case CHK_CONVOYS:
+			FOR(vector_tpl<convoihandle_t>, const cnv, convoi_array) {
+				cnv->rdwr(&ls);
+			}
+			break;
+		case CHK_HALTS:
+			FOR(vector_tpl<halthandle_t>, const halt, haltestelle_t::get_alle_haltestellen()) {
+				halt->rdwr(&ls);
+			}
+			break;
+		case CHK_FACTORIES:
+			FOR(vector_tpl<fabrik_t*>, const fab, fab_list) {
+				fab->rdwr(&ls);
+			}
+			break;
+		case CHK_CITIES:
+			FOR(weighted_vector_tpl<stadt_t*>, const city, stadt) {
+				city->rdwr(&ls);
+			}
+			break;
+		case CHK_FINANCES:
+			for(  uint8 i = 0;  i < MAX_PLAYER_COUNT;  i++  ) {
+				if(  players[i]  ) {
+					players[i]->get_finance()->rdwr(&ls);
+				}
+			}
+			break;
+		case CHK_WAYS:
+			FOR(vector_tpl<weg_t*>, const way, weg_t::get_alle_wege()) {
+				way->rdwr(&ls);
+			}
+			break;
+		case CHK_GAMESTATE:
+			rdwr_gamestate(&ls, NULL);
+			break;
+		default:
+			break;
+	}
+	// never 0, which stands for "not hashed"
+	return stream->get_hash() | 1;
+}
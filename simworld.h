@@ -18,6 +18,7 @@
 #include "tpl/vector_tpl.h"
 #include "tpl/slist_tpl.h"
 #include "tpl/koordhashtable_tpl.h"
+#include "tpl/spatial_grid_tpl.h"
 
 #include "dataobj/settings.h"
 #include "network/pwd_hash.h"
@@ -132,6 +133,8 @@ public:
  * Threaded function caller.
  */
 typedef void (karte_t::*xy_loop_func)(sint16, sint16, sint16, sint16 /*, sint32*/);
+typedef void (karte_t::*index_loop_func)(uint32, uint32);
+typedef void (*index_loop_callback)(void *data, uint32 first, uint32 last);
 
 
 /**
@@ -373,6 +376,17 @@ private:
 
 	weighted_vector_tpl<gebaeude_t *> world_attractions;
 
+	/**
+	 * Spatial index of the factories. It is kept up to date by add_fab() and rem_fab()
+	 * and rebuilt on the main thread after loading, rotating or enlarging the map.
+	 */
+	spatial_grid_tpl<fabrik_t *> factory_grid;
+
+	void rebuild_factory_grid();
+
+	/// changes whenever a building is added to, removed from or reweighted in the passenger/mail lists
+	uint32 building_list_generation;
+
 	slist_tpl<koord> labels;
 
 	/**
@@ -806,6 +820,39 @@ private:
 	void world_xy_loop(xy_loop_func func, uint8 flags);
 	static void *world_xy_loop_thread(void *);
 
+	/**
+	 * Calls func(first, last) for consecutive parts of 0..count-1, using the
+	 * same threads as world_xy_loop(). No simrand() allowed in func either.
+	 */
+	void world_index_loop(index_loop_func func, uint32 count);
+	void world_index_loop_xy(sint16, sint16, sint16, sint16);
+	index_loop_func index_loop_function;
+	uint32 index_loop_count;
+
+	void world_index_loop_callback(uint32 first, uint32 last);
+	index_loop_callback index_loop_callback_function;
+	void *index_loop_callback_data;
+
+	/**
+	 * Production and consumption of the factories first..last-1 in fab_list.
+	 */
+	void step_factories_production(uint32 first, uint32 last);
+	uint32 factory_step_delta_t;
+
+	/**
+	 * Monthly statistics and wear of the ways first..last-1 in weg_t::get_alle_wege().
+	 * Worn out ways are collected in worn_out_ways.
+	 */
+	void new_month_ways(uint32 first, uint32 last);
+	vector_tpl<uint32> worn_out_ways;
+
+	/**
+	 * Looks up whether the worn out ways first..last-1 are in a city,
+	 * the costly part of their renewal, into worn_out_ways_in_city.
+	 */
+	void check_worn_out_ways_in_city(uint32 first, uint32 last);
+	vector_tpl<bool> worn_out_ways_in_city;
+
 	/**
 	 * Loops over plans after load.
 	 */
@@ -1203,6 +1250,16 @@ public:
 	const pwd_hash_t& get_player_password_hash( uint8 player_nr ) const { return player_password_hash[player_nr]; }
 	void clear_player_password_hashes();
 	void rdwr_player_password_hashes(loadsave_t *file);
+
+	/**
+	 * Brings the server and all other clients, at the sync step where the snapshot
+	 * for a joining client is saved, into the state the joining client has after
+	 * loading it (see server_snapshot_join).
+	 * Rule: any state which is not saved but influences the simulation must either
+	 * be a pure function of the saved state, or be reset here the same way as
+	 * when loading.
+	 */
+	void reset_unsaved_state();
 	void remove_player(uint8 player_nr);
 
 	/**
@@ -2227,6 +2284,18 @@ public:
 	void remove_attraction(gebaeude_t *gb);
 	const weighted_vector_tpl<gebaeude_t*> &get_attractions() const {return world_attractions; }
 
+	/// spatial index of the factories for range queries; never changed while the world threads run
+	const spatial_grid_tpl<fabrik_t *> &get_factory_grid() const { return factory_grid; }
+
+	/// for caches of sums over buildings, see building_list_generation
+	uint32 get_building_list_generation() const { return building_list_generation; }
+
+	/**
+	 * Calls func(data, first, last) for consecutive parts of 0..count-1 in parallel.
+	 * Only for read-only work from the main thread; no simrand() allowed in func.
+	 */
+	void world_index_loop(index_loop_callback func, void *data, uint32 count);
+
 	void add_label(koord k) { if (!labels.is_contained(k)) labels.append(k); }
 	void remove_label(koord k) { labels.remove(k); }
 	const slist_tpl<koord>& get_label_list() const { return labels; }
@@ -2463,8 +2532,19 @@ public:
 	/**
 	 * Saves the map to a file.
 	 * @param filename name of the file to write.
+	 * @param tee if given, the file data is also written to this stream while saving.
+	 */
+	void save(const char *filename, bool autosave, const char *version, const char *ex_version, const char* ex_revision, bool silent, rdwr_stream_t *tee = NULL, const char *delta_base = NULL);
+
+	/**
+	 * Autosaves the map from a forked copy of the game, which continues meanwhile.
+	 * Skips the save while the previous one is still running.
+	 * @return false if the game has to be saved in the foreground instead
 	 */
-	void save(const char *filename, bool autosave, const char *version, const char *ex_version, const char* ex_revision, bool silent);
+	bool save_in_background(const char *filename, const char *version, const char *ex_version, const char* ex_revision);
+
+	/// reaps a finished background save and reports a failure
+	void check_background_save();
 
 	/**
 	 * Loads a map from a file.
@@ -2552,6 +2632,12 @@ public:
 	 */
 	uint32 get_gamestate_hash();
 
+	/**
+	 * Generates hash of one part of the game state (CHK_CONVOYS ...),
+	 * much cheaper than hashing the whole game (CHK_GAMESTATE).
+	 */
+	uint32 get_gamestate_hash(uint8 subsystem);
+
 	/**
 	 * Time printing routines.
 	 * Should be inlined.
@@ -45,6 +45,7 @@
 #	include <dirent.h>
 #	if !defined __AMIGA__ && !defined __BEOS__
 #		include <unistd.h>
+#		include <sys/wait.h>
 #	endif
 #endif
 
@@ -376,6 +377,50 @@ char const *dr_query_homedir()
 }
 
 
+int dr_fork()
+{
+#if defined _WIN32 || defined __AMIGA__ || defined __BEOS__
+	return -1;
+#else
+	fflush(NULL);
+	return fork();
+#endif
+}
+
+
+bool dr_child_running(int pid, bool *failed)
+{
+#if defined _WIN32 || defined __AMIGA__ || defined __BEOS__
+	(void)pid;
+	(void)failed;
+	return false;
+#else
+	if(  pid <= 0  ) {
+		return false;
+	}
+	int status = 0;
+	const int ret = waitpid(pid, &status, WNOHANG);
+	if(  ret == 0  ) {
+		return true;
+	}
+	if(  failed  ) {
+		*failed = ret != pid  ||  !WIFEXITED(status)  ||  WEXITSTATUS(status) != 0;
+	}
+	return false;
+#endif
+}
+
+
+void dr_exit_child(int status)
+{
+#if defined _WIN32 || defined __AMIGA__ || defined __BEOS__
+	exit(status);
+#else
+	_exit(status);
+#endif
+}
+
+
 const char *dr_query_fontpath(int which)
 {
 	static char buffer[PATH_MAX];
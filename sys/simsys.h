@@ -131,6 +131,21 @@ int dr_stat(const char *path, struct stat *buf);
 /* query home directory */
 char const* dr_query_homedir();
 
+/**
+ * starts a child process with a copy-on-write image of this process
+ * @return 0 in the child, the process id in the parent, -1 if not supported or failed
+ */
+int dr_fork();
+
+/**
+ * @return true if the child process is still running; a finished child is reaped
+ * @param failed set to true if the reaped child did not exit with status 0
+ */
+bool dr_child_running(int pid, bool *failed = NULL);
+
+/// ends a child process started by dr_fork() without any cleanup of the parent's resources
+void dr_exit_child(int status);
+
 unsigned short* dr_textur_init();
 
 // returns the file path to a font file (or more than one, if used with number higher than zero)
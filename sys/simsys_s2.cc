@@ -34,6 +34,7 @@ extern char **__argv;
 #include "../gui/components/gui_textinput.h"
 #include "../simintr.h"
 #include "../simworld.h"
+#include "../tpl/vector_tpl.h"
 
 
 // Maybe Linux is not fine too, had critical bugs...
@@ -471,10 +472,9 @@ unsigned short *dr_textur_init()
  */
 unsigned int get_system_color(unsigned int r, unsigned int g, unsigned int b)
 {
-	SDL_PixelFormat *fmt = SDL_AllocFormat( SDL_PIXELFORMAT_RGB565 );
-	unsigned int ret = SDL_MapRGB( fmt, (Uint8)r, (Uint8)g, (Uint8)b );
-	SDL_FreeFormat( fmt );
-	return ret;
+	// called for every entry of the colour maps, so allocate the format only once
+	static SDL_PixelFormat *fmt = SDL_AllocFormat( SDL_PIXELFORMAT_RGB565 );
+	return SDL_MapRGB( fmt, (Uint8)r, (Uint8)g, (Uint8)b );
 }
 
 
@@ -484,12 +484,41 @@ void dr_prepare_flush()
 }
 
 
+// rectangles updated since the last flush, uploaded together in dr_flush()
+static vector_tpl<SDL_Rect> dirty_rects;
+static sint64 dirty_area = 0;
+
+
+static void upload_rect(const SDL_Rect &r)
+{
+	SDL_UpdateTexture( screen_tx, &r, (uint8 *)screen->pixels + r.y * screen->pitch + r.x * sizeof(PIXVAL), screen->pitch );
+}
+
+
 void dr_flush()
 {
 	display_flush_buffer();
-	if(  !use_dirty_tiles  ) {
+	if(  !use_dirty_tiles  ||  dirty_area * 2 >= (sint64)screen->w * screen->h  ) {
+		// (nearly) full frame
 		SDL_UpdateTexture( screen_tx, NULL, screen->pixels, screen->pitch );
 	}
+	else if(  !dirty_rects.empty()  ) {
+		// one upload of the bounding box, unless it contains mostly clean pixels
+		SDL_Rect bbox = dirty_rects[0];
+		FOR(vector_tpl<SDL_Rect>, const& r, dirty_rects) {
+			SDL_UnionRect( &bbox, &r, &bbox );
+		}
+		if(  (sint64)bbox.w * bbox.h <= dirty_area + dirty_area / 2  ) {
+			upload_rect( bbox );
+		}
+		else {
+			FOR(vector_tpl<SDL_Rect>, const& r, dirty_rects) {
+				upload_rect( r );
+			}
+		}
+	}
+	dirty_rects.clear();
+	dirty_area = 0;
 
 	SDL_Rect rSrc  = { 0, 0, display_get_width(), display_get_height()  };
 	SDL_RenderCopy( renderer, screen_tx, &rSrc, NULL );
@@ -506,9 +535,14 @@ void dr_textur(int xp, int yp, int w, int h)
 		r.y = yp;
 		r.w = xp + w > screen->w ? screen->w - xp : w;
 		r.h = yp + h > screen->h ? screen->h - yp : h;
-		SDL_UpdateTexture( screen_tx, &r, (uint8 *)screen->pixels + yp * screen->pitch + xp * sizeof(PIXVAL), screen->pitch );
+		if(  r.w > 0  &&  r.h > 0  ) {
+			dirty_rects.append( r );
+			dirty_area += (sint64)r.w * r.h;
+		}
 	}
 }
+
+
 static bool in_finger_handling = false;
 
 // move cursor to the specified location
@@ -0,0 +1,137 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef TPL_SPATIAL_GRID_TPL_H
+#define TPL_SPATIAL_GRID_TPL_H
+
+
+#include "vector_tpl.h"
+#include "../dataobj/koord.h"
+#include "../simtypes.h"
+
+
+/**
+ * A uniform grid over the map for answering "what is near X" without
+ * scanning all objects. Each object is stored once, in the cell of its
+ * origin, together with its footprint. A cell covers 2^shift x 2^shift tiles.
+ * Results come in a deterministic order (cells row by row, then order of
+ * insertion), so they may be used in network games.
+ */
+template<class T> class spatial_grid_tpl
+{
+private:
+	struct entry_t
+	{
+		T obj;
+		koord pos;
+		koord size;
+	};
+
+	vector_tpl<entry_t> *cells;
+	koord cell_count;
+	uint8 shift;
+	koord max_size; ///< largest footprint ever added, to find objects reaching into a rectangle
+	uint32 count;
+
+	vector_tpl<entry_t> *get_cell(koord pos) const
+	{
+		const sint32 x = clamp( (sint32)pos.x >> shift, 0, cell_count.x-1 );
+		const sint32 y = clamp( (sint32)pos.y >> shift, 0, cell_count.y-1 );
+		return cells + (x + y*cell_count.x);
+	}
+
+	spatial_grid_tpl(const spatial_grid_tpl&);
+	spatial_grid_tpl& operator=(const spatial_grid_tpl&);
+
+public:
+	explicit spatial_grid_tpl(uint8 shift = 4) : cells(NULL), cell_count(0,0), shift(shift), max_size(1,1), count(0) {}
+
+	~spatial_grid_tpl() { delete [] cells; }
+
+	/// removes all objects and resizes the grid to cover @p map_size tiles
+	void init(koord map_size)
+	{
+		delete [] cells;
+		cell_count = koord( max( 1, (map_size.x + (1<<shift) - 1) >> shift ), max( 1, (map_size.y + (1<<shift) - 1) >> shift ) );
+		cells = new vector_tpl<entry_t>[cell_count.x * cell_count.y];
+		max_size = koord(1,1);
+		count = 0;
+	}
+
+	void clear()
+	{
+		delete [] cells;
+		cells = NULL;
+		cell_count = koord(0,0);
+		max_size = koord(1,1);
+		count = 0;
+	}
+
+	uint32 get_count() const { return count; }
+
+	/// @param size footprint in tiles, starting at @p pos
+	void add(T obj, koord pos, koord size = koord(1,1))
+	{
+		if(  cells == NULL  ) {
+			return;
+		}
+		vector_tpl<entry_t> &cell = *get_cell(pos);
+		for(  uint32 i = 0;  i < cell.get_count();  i++  ) {
+			if(  cell[i].obj == obj  ) {
+				return;
+			}
+		}
+		entry_t e;
+		e.obj = obj;
+		e.pos = pos;
+		e.size = size;
+		cell.append( e );
+		max_size.x = max( max_size.x, size.x );
+		max_size.y = max( max_size.y, size.y );
+		count++;
+	}
+
+	/// @param pos must be the position the object was added with
+	bool remove(T obj, koord pos)
+	{
+		if(  cells == NULL  ) {
+			return false;
+		}
+		vector_tpl<entry_t> &cell = *get_cell(pos);
+		for(  uint32 i = 0;  i < cell.get_count();  i++  ) {
+			if(  cell[i].obj == obj  ) {
+				cell.remove_at( i );
+				count--;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/// appends all objects whose footprint overlaps the rectangle from @p min_pos to @p max_pos (inclusive)
+	void get_in_rect(koord min_pos, koord max_pos, vector_tpl<T> &result) const
+	{
+		if(  cells == NULL  ) {
+			return;
+		}
+		const vector_tpl<entry_t> *first = get_cell( min_pos - max_size + koord(1,1) );
+		const vector_tpl<entry_t> *last = get_cell( max_pos );
+		const sint32 x0 = (first - cells) % cell_count.x, y0 = (first - cells) / cell_count.x;
+		const sint32 x1 = (last - cells) % cell_count.x, y1 = (last - cells) / cell_count.x;
+		for(  sint32 y = y0;  y <= y1;  y++  ) {
+			for(  sint32 x = x0;  x <= x1;  x++  ) {
+				const vector_tpl<entry_t> &cell = cells[x + y*cell_count.x];
+				for(  uint32 i = 0;  i < cell.get_count();  i++  ) {
+					const entry_t &e = cell[i];
+					if(  e.pos.x <= max_pos.x  &&  e.pos.y <= max_pos.y  &&  e.pos.x + e.size.x > min_pos.x  &&  e.pos.y + e.size.y > min_pos.y  ) {
+						result.append( e.obj );
+					}
+				}
+			}
+		}
+	}
+};
+
+#endif
@@ -12,6 +12,10 @@
 #include <cstring>
 
 
+const char *checklist_t::subsystem_names[CHK_SUBSYSTEMS] = {
+	"convoys", "halts", "factories", "cities", "finances", "ways", "all"
+};
+
 checklist_t::checklist_t() :
 	hash(0),
 	random_seed(0),
@@ -28,6 +32,9 @@ checklist_t::checklist_t() :
 	for(  uint8 i = 0;  i < CHK_DEBUG_SUMS;  i++  ) {
 		debug_sum[i] = 0;
 	}
+	for(  uint8 i = 0;  i < CHK_SUBSYSTEMS;  i++  ) {
+		subsystem_hash[i] = 0;
+	}
 }
 
 
@@ -47,6 +54,9 @@ checklist_t::checklist_t(const uint32 &hash) :
 	for(  uint8 i = 0;  i < CHK_DEBUG_SUMS;  i++  ) {
 		debug_sum[i] = 0;
 	}
+	for(  uint8 i = 0;  i < CHK_SUBSYSTEMS;  i++  ) {
+		subsystem_hash[i] = 0;
+	}
 }
 
 
@@ -67,12 +77,48 @@ checklist_t::checklist_t(uint32 _ss, uint32 _st, uint8 _nfc, uint32 _random_seed
 	for(  uint8 i = 0;  i < CHK_DEBUG_SUMS;  i++  ) {
 		debug_sum[i] = _debug_sums[i];
 	}
+	for(  uint8 i = 0;  i < CHK_SUBSYSTEMS;  i++  ) {
+		subsystem_hash[i] = 0;
+	}
+}
+
+
+checklist_t::checklist_t(const uint32 &hash, const uint32 *_subsystem_hashes) :
+	hash(hash),
+	random_seed(0),
+	halt_entry(0),
+	line_entry(0),
+	convoy_entry(0),
+	ss(0),
+	st(0),
+	nfc(0)
+{
+	for(  uint8 i = 0;  i < CHK_RANDS;  i++  ) {
+		rand[i] = 0;
+	}
+	for(  uint8 i = 0;  i < CHK_DEBUG_SUMS;  i++  ) {
+		debug_sum[i] = 0;
+	}
+	for(  uint8 i = 0;  i < CHK_SUBSYSTEMS;  i++  ) {
+		subsystem_hash[i] = _subsystem_hashes[i];
+	}
+}
+
+
+uint8 checklist_t::get_mismatched_subsystem(const checklist_t &other) const
+{
+	// only the parts hashed on both sides can be compared
+	uint8 i = 0;
+	while(  i < CHK_SUBSYSTEMS  &&  (subsystem_hash[i] == 0  ||  other.subsystem_hash[i] == 0  ||  subsystem_hash[i] == other.subsystem_hash[i])  ) {
+		i++;
+	}
+	return i;
 }
 
 
 bool checklist_t::operator==(const checklist_t& other) const
 {
-	if (hash != other.hash) {
+	if (hash != other.hash  ||  get_mismatched_subsystem(other) != CHK_SUBSYSTEMS) {
 		return false;
 	}
 
@@ -121,13 +167,25 @@ void checklist_t::rdwr(memory_rw_t *buffer)
 	for(  uint8 i = 0;  i < CHK_DEBUG_SUMS;  i++  ) {
 		buffer->rdwr_long(debug_sum[i]);
 	}
+	for(  uint8 i = 0;  i < CHK_SUBSYSTEMS;  i++  ) {
+		buffer->rdwr_long(subsystem_hash[i]);
+	}
 }
 
 
 void checklist_t::print(cbuffer_t &buffer, const char *entity) const
 {
 	if (env_t::network_heavy_mode >=1) {
-		buffer.printf("%s=[adler32=%08x]", entity, hash);
+		// adler32 of the parts hashed at this sync step
+		buffer.printf("%s=[", entity);
+		const char *separator = "";
+		for(  uint8 i = 0;  i < CHK_SUBSYSTEMS;  i++  ) {
+			if(  subsystem_hash[i]  ) {
+				buffer.printf("%s%s=%08x", separator, subsystem_names[i], subsystem_hash[i]);
+				separator = " ";
+			}
+		}
+		buffer.append("]");
 	}
 	else {
 		buffer.printf("%s=[ss=%u st=%u nfc=%u  rand=%u halt=%u line=%u cnvy=%u\n\tssr=%u,%u,%u,%u,%u,%u,%u,%u\n\tstr=%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n\texr=%u,%u,%u,%u,%u,%u,%u,%u\n\tsums=%u,%u,%u,%u,%u,%u,%u,%u,%u,%u]\n",
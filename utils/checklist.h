@@ -15,6 +15,18 @@ class cbuffer_t;
 #define CHK_RANDS 32
 #define CHK_DEBUG_SUMS 10
 
+/// parts of the game state which are hashed separately in network heavy mode; CHK_GAMESTATE is all of it
+enum {
+	CHK_CONVOYS = 0,
+	CHK_HALTS,
+	CHK_FACTORIES,
+	CHK_CITIES,
+	CHK_FINANCES,
+	CHK_WAYS,
+	CHK_GAMESTATE,
+	CHK_SUBSYSTEMS
+};
+
 struct checklist_t
 {
 private:
@@ -31,14 +43,23 @@ private:
 	uint32 rand[CHK_RANDS];
 	uint32 debug_sum[CHK_DEBUG_SUMS];
 
+	/// 0 if this subsystem was not hashed at this sync step
+	uint32 subsystem_hash[CHK_SUBSYSTEMS];
+
 public:
+	static const char *subsystem_names[CHK_SUBSYSTEMS];
+
 	checklist_t();
 	explicit checklist_t(const uint32 &hash);
+	checklist_t(const uint32 &hash, const uint32 *_subsystem_hashes);
 	checklist_t(uint32 _ss, uint32 _st, uint8 _nfc, uint32 _random_seed, uint16 _halt_entry, uint16 _line_entry, uint16 _convoy_entry, uint32 *_rands, uint32 *_debug_sums);
 
 	bool operator == (const checklist_t &other) const;
 	bool operator != (const checklist_t &other) const { return !( *this==other ); }
 
+	/// @return first subsystem hashed in both checklists whose hash differs, or CHK_SUBSYSTEMS if none
+	uint8 get_mismatched_subsystem(const checklist_t &other) const;
+
 	void rdwr(memory_rw_t *buffer);
 	void print(cbuffer_t &buffer, const char *entity) const;
 };